@@ -0,0 +1,145 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Benchmark runner, reporting results as JSON.
+ *
+ * Usage: poco_bench [--output FILE] [FILTER]
+ *
+ * Only benchmarks whose name contains FILTER are run. Results are written to stdout,
+ * or FILE if given, so runs on different commits can be compared directly.
+ */
+
+#include "bench.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/** Number of times each benchmark is repeated, the fastest run is reported. */
+#define BENCH_REPETITIONS (5)
+
+int64_t bench_now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((int64_t)now.tv_sec * 1000000000) + now.tv_nsec;
+}
+
+int64_t bench_run_scheduler(Scheduler *const scheduler, Coro **const tasks,
+                            size_t const task_count) {
+    int64_t elapsed = -1;
+
+    if (scheduler != NULL) {
+        int64_t const start = bench_now_ns();
+        scheduler_run(scheduler);
+        elapsed = bench_now_ns() - start;
+
+        round_round_robin_scheduler_free((RoundRobinScheduler *)scheduler);
+    }
+
+    for (size_t idx = 0; idx < task_count; ++idx) {
+        if (tasks[idx] != NULL) {
+            coro_free(tasks[idx]);
+        }
+    }
+
+    return elapsed;
+}
+
+static bool run_case(FILE *const output, BenchCase const *const bench_case,
+                     bool const first) {
+    int64_t best = -1;
+
+    for (size_t rep = 0; rep < BENCH_REPETITIONS; ++rep) {
+        int64_t const elapsed = bench_case->run(bench_case->parameter,
+                                                bench_case->operations);
+        if (elapsed < 0) {
+            fprintf(stderr, "%s(%zu) failed\n", bench_case->name,
+                    bench_case->parameter);
+            return false;
+        }
+        if ((best < 0) || (elapsed < best)) {
+            best = elapsed;
+        }
+    }
+
+    double const ns_per_op = (double)best / (double)bench_case->operations;
+    double const ops_per_sec = (ns_per_op > 0.0) ? (1e9 / ns_per_op) : 0.0;
+
+    fprintf(output, "%s\n    {\"name\": \"%s\", \"parameter\": %zu, ", first ? "" : ",",
+            bench_case->name, bench_case->parameter);
+    fprintf(output, "\"operations\": %zu, \"ns_per_op\": %.2f, \"ops_per_sec\": %.0f",
+            bench_case->operations, ns_per_op, ops_per_sec);
+    if (bench_case->bytes_per_operation != 0) {
+        fprintf(output, ", \"bytes_per_sec\": %.0f",
+                ops_per_sec * (double)bench_case->bytes_per_operation);
+    }
+    fprintf(output, "}");
+    fflush(output);
+
+    return true;
+}
+
+static bool run_cases(FILE *const output, BenchCase const *const cases,
+                      size_t const case_count, char const *const filter,
+                      bool *const first) {
+    bool success = true;
+
+    for (size_t idx = 0; idx < case_count; ++idx) {
+        if ((filter != NULL) && (strstr(cases[idx].name, filter) == NULL)) {
+            continue;
+        }
+        success = run_case(output, &cases[idx], *first) && success;
+        *first = false;
+    }
+
+    return success;
+}
+
+int main(int argc, char **argv) {
+    FILE *output = stdout;
+    char const *filter = NULL;
+
+    for (int idx = 1; idx < argc; ++idx) {
+        if ((strcmp(argv[idx], "--output") == 0) && ((idx + 1) < argc)) {
+            output = fopen(argv[++idx], "w");
+            if (output == NULL) {
+                perror(argv[idx]);
+                return 1;
+            }
+        } else {
+            filter = argv[idx];
+        }
+    }
+
+#ifdef POCO_WITH_ASM_CONTEXT
+    char const *const asm_context = "true";
+#else
+    char const *const asm_context = "false";
+#endif
+#ifdef POCO_WITH_THREADS
+    char const *const threads = "true";
+#else
+    char const *const threads = "false";
+#endif
+
+    fprintf(output, "{\n  \"context\": {\"asm_context\": %s, \"threads\": %s, ",
+            asm_context, threads);
+    fprintf(output, "\"repetitions\": %d},\n  \"benchmarks\": [", BENCH_REPETITIONS);
+
+    bool first = true;
+    bool success = run_cases(output, bench_primitive_cases, bench_primitive_case_count,
+                             filter, &first);
+    success = run_cases(output, bench_scheduler_cases, bench_scheduler_case_count,
+                        filter, &first) &&
+              success;
+
+    fprintf(output, "\n  ]\n}\n");
+
+    if (output != stdout) {
+        fclose(output);
+    }
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,56 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Minimal benchmark harness.
+ *
+ * Each benchmark performs a fixed number of operations and reports the time they took.
+ * Benchmarks are repeated, and the fastest repetition is reported, as it is the least
+ * disturbed by the rest of the system.
+ */
+
+#pragma once
+
+#include <poco/poco.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*!
+ * @brief Runs a benchmark once.
+ *
+ * @param parameter Benchmark specific parameter, e.g. a task count.
+ * @param operations Number of operations to perform.
+ *
+ * @return Nanoseconds taken by the operations, excluding setup and teardown, or a
+ *      negative value on error.
+ */
+typedef int64_t (*BenchRun)(size_t parameter, size_t operations);
+
+typedef struct bench_case {
+    char const *name;
+    BenchRun run;
+    size_t parameter;
+    size_t operations;
+    size_t bytes_per_operation; /**< Non-zero for throughput benchmarks. */
+} BenchCase;
+
+/*!
+ * @brief Gets the monotonic clock, in nanoseconds.
+ */
+int64_t bench_now_ns(void);
+
+/*!
+ * @brief Runs a round robin scheduler, returning how long it ran for in nanoseconds.
+ *
+ * The scheduler is freed once done, along with the provided coroutines, even if the
+ * scheduler could not be created.
+ */
+int64_t bench_run_scheduler(Scheduler *scheduler, Coro **tasks, size_t task_count);
+
+/** Benchmarks of the coroutine and communication primitives. */
+extern BenchCase const bench_primitive_cases[];
+extern size_t const bench_primitive_case_count;
+
+/** Benchmarks of the scheduler, as the number of tasks grows. */
+extern BenchCase const bench_scheduler_cases[];
+extern size_t const bench_scheduler_case_count;
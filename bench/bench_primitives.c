@@ -0,0 +1,217 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Benchmarks of the coroutine and communication primitives.
+ *
+ * Each benchmark runs a pair of coroutines under the round robin scheduler, passing
+ * control back and forth through the primitive being measured.
+ */
+
+#include "bench.h"
+
+#include <poco/mutex.h>
+
+#define STREAM_BUFFER_SIZE (4096)
+#define STREAM_CHUNK_SIZE (256)
+
+/** State shared between the two coroutines of a benchmark. */
+typedef struct bench_pair {
+    size_t operations;
+    Queue *queue;
+    Queue *reply_queue;
+    Stream *stream;
+    Mutex *mutex;
+    Semaphore *ping;
+    Semaphore *pong;
+} BenchPair;
+
+static int64_t run_pair(CoroEntrypoint const first, CoroEntrypoint const second,
+                        BenchPair *const pair) {
+    Coro *tasks[2] = {
+        coro_create(first, pair, DEFAULT_STACK_SIZE),
+        coro_create(second, pair, DEFAULT_STACK_SIZE),
+    };
+
+    Scheduler *scheduler = NULL;
+    if ((tasks[0] != NULL) && (tasks[1] != NULL)) {
+        scheduler = round_robin_scheduler_create(tasks, 2);
+    }
+
+    return bench_run_scheduler(scheduler, tasks, 2);
+}
+
+static void yield_task(void *context) {
+    BenchPair const *const pair = context;
+    for (size_t idx = 0; idx < pair->operations; ++idx) {
+        coro_yield();
+    }
+}
+
+/*!
+ * @brief Round trip of a yield, switching to the other coroutine and back again.
+ */
+static int64_t bench_coro_yield(size_t parameter, size_t operations) {
+    (void)parameter;
+    BenchPair pair = {.operations = operations};
+    return run_pair(yield_task, yield_task, &pair);
+}
+
+static void queue_ping_task(void *context) {
+    BenchPair const *const pair = context;
+    for (size_t idx = 0; idx < pair->operations; ++idx) {
+        uint32_t item = (uint32_t)idx;
+        queue_put(pair->queue, &item, PLATFORM_TICKS_FOREVER);
+        queue_get(pair->reply_queue, &item, PLATFORM_TICKS_FOREVER);
+    }
+}
+
+static void queue_pong_task(void *context) {
+    BenchPair const *const pair = context;
+    for (size_t idx = 0; idx < pair->operations; ++idx) {
+        uint32_t item = 0;
+        queue_get(pair->queue, &item, PLATFORM_TICKS_FOREVER);
+        queue_put(pair->reply_queue, &item, PLATFORM_TICKS_FOREVER);
+    }
+}
+
+/*!
+ * @brief Round trip of an item through a pair of single item queues.
+ */
+static int64_t bench_queue_ping_pong(size_t parameter, size_t operations) {
+    (void)parameter;
+    BenchPair pair = {
+        .operations = operations,
+        .queue = queue_create(1, sizeof(uint32_t)),
+        .reply_queue = queue_create(1, sizeof(uint32_t)),
+    };
+
+    int64_t elapsed = -1;
+    if ((pair.queue != NULL) && (pair.reply_queue != NULL)) {
+        elapsed = run_pair(queue_ping_task, queue_pong_task, &pair);
+    }
+
+    queue_free(pair.queue);
+    queue_free(pair.reply_queue);
+    return elapsed;
+}
+
+static void stream_send_task(void *context) {
+    BenchPair const *const pair = context;
+    uint8_t chunk[STREAM_CHUNK_SIZE] = {0};
+    for (size_t idx = 0; idx < pair->operations; ++idx) {
+        size_t size = sizeof(chunk);
+        stream_send(pair->stream, chunk, &size, PLATFORM_TICKS_FOREVER);
+    }
+}
+
+static void stream_receive_task(void *context) {
+    BenchPair const *const pair = context;
+    uint8_t chunk[STREAM_CHUNK_SIZE];
+    for (size_t idx = 0; idx < pair->operations; ++idx) {
+        size_t size = sizeof(chunk);
+        stream_receive(pair->stream, chunk, &size, PLATFORM_TICKS_FOREVER);
+    }
+}
+
+/*!
+ * @brief Throughput of a stream, in chunks sent and received.
+ */
+static int64_t bench_stream_throughput(size_t parameter, size_t operations) {
+    (void)parameter;
+    BenchPair pair = {
+        .operations = operations,
+        .stream = stream_create(STREAM_BUFFER_SIZE),
+    };
+
+    int64_t elapsed = -1;
+    if (pair.stream != NULL) {
+        elapsed = run_pair(stream_send_task, stream_receive_task, &pair);
+    }
+
+    stream_free(pair.stream);
+    return elapsed;
+}
+
+static void mutex_task(void *context) {
+    BenchPair const *const pair = context;
+    for (size_t idx = 0; idx < pair->operations; ++idx) {
+        mutex_acquire(pair->mutex, PLATFORM_TICKS_FOREVER);
+        coro_yield();
+        mutex_release(pair->mutex);
+        coro_yield();
+    }
+}
+
+/*!
+ * @brief Handoff of a contended mutex between two coroutines.
+ *
+ * Each coroutine yields while holding the mutex, so the other always blocks on it.
+ */
+static int64_t bench_mutex_handoff(size_t parameter, size_t operations) {
+    (void)parameter;
+    BenchPair pair = {
+        .operations = operations,
+        .mutex = mutex_create(),
+    };
+
+    int64_t elapsed = -1;
+    if (pair.mutex != NULL) {
+        elapsed = run_pair(mutex_task, mutex_task, &pair);
+    }
+
+    mutex_free(pair.mutex);
+    return elapsed;
+}
+
+static void semaphore_ping_task(void *context) {
+    BenchPair const *const pair = context;
+    for (size_t idx = 0; idx < pair->operations; ++idx) {
+        semaphore_release(pair->ping);
+        semaphore_acquire(pair->pong, PLATFORM_TICKS_FOREVER);
+    }
+}
+
+static void semaphore_pong_task(void *context) {
+    BenchPair const *const pair = context;
+    for (size_t idx = 0; idx < pair->operations; ++idx) {
+        semaphore_acquire(pair->ping, PLATFORM_TICKS_FOREVER);
+        semaphore_release(pair->pong);
+    }
+}
+
+/*!
+ * @brief Round trip of a signal through a pair of binary semaphores.
+ */
+static int64_t bench_semaphore_ping_pong(size_t parameter, size_t operations) {
+    (void)parameter;
+    BenchPair pair = {
+        .operations = operations,
+        .ping = semaphore_create_binary(),
+        .pong = semaphore_create_binary(),
+    };
+
+    int64_t elapsed = -1;
+    if ((pair.ping != NULL) && (pair.pong != NULL)) {
+        // Semaphores start available, take them so that each release is a signal
+        semaphore_acquire_no_wait(pair.ping);
+        semaphore_acquire_no_wait(pair.pong);
+        elapsed = run_pair(semaphore_ping_task, semaphore_pong_task, &pair);
+    }
+
+    semaphore_free(pair.ping);
+    semaphore_free(pair.pong);
+    return elapsed;
+}
+
+BenchCase const bench_primitive_cases[] = {
+    {"coro_yield", bench_coro_yield, 2, 1000000, 0},
+    {"queue_ping_pong", bench_queue_ping_pong, 2, 200000, 0},
+    {"stream_throughput", bench_stream_throughput, STREAM_CHUNK_SIZE, 200000,
+     STREAM_CHUNK_SIZE},
+    {"mutex_handoff", bench_mutex_handoff, 2, 200000, 0},
+    {"semaphore_ping_pong", bench_semaphore_ping_pong, 2, 200000, 0},
+};
+
+size_t const bench_primitive_case_count =
+    sizeof(bench_primitive_cases) / sizeof(bench_primitive_cases[0]);
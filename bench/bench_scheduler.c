@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Benchmarks of the scheduler overhead as the number of tasks grows.
+ *
+ * Every task yields a number of times, so that the total number of yields stays roughly
+ * constant. The cost per yield should stay flat as the task count grows, any growth
+ * shows scheduler overhead that scales with the number of tasks.
+ */
+
+#include "bench.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/** Total number of yields across all tasks. */
+#define SCHEDULER_TOTAL_YIELDS (1000000)
+/** Minimum number of yields of each task, so that even large task counts switch. */
+#define SCHEDULER_MIN_YIELDS (2)
+
+/** Number of yields performed by task_count tasks. */
+#define SCALING_OPERATIONS(task_count)                                                 \
+    (((SCHEDULER_TOTAL_YIELDS / (task_count)) < SCHEDULER_MIN_YIELDS)                  \
+         ? (SCHEDULER_MIN_YIELDS * (task_count))                                       \
+         : (SCHEDULER_TOTAL_YIELDS / (task_count)) * (task_count))
+
+#define SCALING_CASE(task_count)                                                       \
+    {"scheduler_scaling", bench_scheduler_scaling, (task_count),                       \
+     SCALING_OPERATIONS(task_count), 0}
+
+static void scaling_task(void *context) {
+    size_t const yields = *(size_t const *)context;
+    for (size_t idx = 0; idx < yields; ++idx) {
+        coro_yield();
+    }
+}
+
+/*!
+ * @brief Runs a number of tasks that share the operations between them.
+ *
+ * Tasks use the smallest stack possible, so that large task counts fit in memory.
+ */
+static int64_t bench_scheduler_scaling(size_t const task_count,
+                                       size_t const operations) {
+    size_t yields = operations / task_count;
+
+    Coro **tasks = calloc(task_count, sizeof(Coro *));
+    if (tasks == NULL) {
+        return -1;
+    }
+
+    bool created = true;
+    for (size_t idx = 0; created && (idx < task_count); ++idx) {
+        tasks[idx] = coro_create(scaling_task, &yields, MIN_STACK_SIZE);
+        created = (tasks[idx] != NULL);
+    }
+
+    Scheduler *scheduler =
+        created ? round_robin_scheduler_create(tasks, task_count) : NULL;
+    int64_t const elapsed = bench_run_scheduler(scheduler, tasks, task_count);
+
+    free(tasks);
+    return elapsed;
+}
+
+BenchCase const bench_scheduler_cases[] = {
+    SCALING_CASE(10),   SCALING_CASE(100),    SCALING_CASE(1000),
+    SCALING_CASE(10000), SCALING_CASE(100000),
+};
+
+size_t const bench_scheduler_case_count =
+    sizeof(bench_scheduler_cases) / sizeof(bench_scheduler_cases[0]);
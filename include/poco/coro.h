@@ -14,7 +14,11 @@ extern "C" {
 #endif
 
 #include <poco/intracoro.h>
+#include <poco/list.h>
 #include <poco/platform.h>
+#include <poco/result.h>
+#include <poco/stats.h>
+#include <poco/timer_heap.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -53,6 +57,8 @@ typedef enum coro_state {
 
 typedef struct coro Coro;
 
+typedef struct shared_stack SharedStack;
+
 /*!
  * @brief Function declaration for the coroutine entrypoint.
  *
@@ -60,11 +66,71 @@ typedef struct coro Coro;
  */
 typedef void (*CoroEntrypoint)(void *context);
 
+/*!
+ * @brief Function declaration for the step function of a stackless coroutine.
+ *
+ * @param coro Stackless coroutine being resumed.
+ * @param context Provided user context when creating the coroutine.
+ *
+ * @return Signal the coroutine yields with.
+ */
+typedef CoroSignal (*CoroStep)(Coro *coro, void *context);
+
 /*!
  * @brief Represents a coroutine that can be scheduled and executed.
  */
 struct coro {
+    // Scheduling state, read by the scheduler on every pass. Kept together at the
+    // front, away from the stack and context fields.
+    /** The current coroutine state. Schedulers should only have read-access to this. */
+    coro_state_t coro_state;
+
+    /** For a non-running coroutine, this is the signal it last yielded with. */
+    CoroSignal yield_signal;
+
+    /** The event sink item that unblocked this sink, only valid after a blocked
+     * coroutine as been unblocked.
+     */
+    size_t triggered_event_sink_slot;
+
+    /** Managed event source, only valid if the coroutine has notified the scheduler. */
+    CoroEventSource event_source;
+
+    /** Managed event sinks, only valid if the coroutine is blocked. */
+    CoroEventSink event_sinks[EVENT_SINK_SLOT_COUNT];
+
+    /** Scheduler owned list membership, used to track the coroutine while it is ready
+     * to run, or while it waits. */
+    ListNode list_node;
+
+    /** Scheduler owned timer, used to track the deadline of the timeout sink. */
+    TimerNode timer_node;
+
+    /** Scheduler owned index of the coroutine in the scheduler's task table. */
+    size_t task_index;
+
+    /** Coroutine to resume next, set by coro_yield_to() for the scheduler. */
+    Coro *yield_target;
+
+    /** Step function of a stackless coroutine, NULL for a stackful coroutine. */
+    CoroStep step;
+
+    /** User context passed to the step function. */
+    void *step_context;
 
+    /** Label a stackless coroutine resumes from, 0 before its first step. */
+    unsigned int resume_label;
+
+    /** Scheduler owned priority, only used by priority based schedulers. */
+    uint8_t priority;
+
+#ifdef POCO_WITH_STATS
+    /** Runtime statistics, see coro_get_stats(). */
+    CoroStats stats;
+#endif
+
+    // Execution state of stackful coroutines, only touched when the coroutine is
+    // created or switched to. Kept last, stackless coroutines are allocated without it.
     /** Coroutine's main entrypoint function. */
     CoroEntrypoint entrypoint;
 
@@ -76,26 +142,24 @@ struct coro {
      */
     size_t stack_size;
 
-    /** The event sink item that unblocked this sink, only valid after a blocked
-     * coroutine as been unblocked.
-     */
-    size_t triggered_event_sink_slot;
+    /** Shared stack the coroutine runs on, NULL if the stack is its own. */
+    SharedStack *shared_stack;
 
-    /** Managed event source, only valid if the coroutine has notified the scheduler. */
-    CoroEventSource event_source;
+    /** Deepest stack address in use when the coroutine last suspended. */
+    void *stack_pointer;
 
-    /** Managed event sinks, only valid if the coroutine is blocked. */
-    CoroEventSink event_sinks[EVENT_SINK_SLOT_COUNT];
+    /** Frames saved from the shared stack, while another coroutine runs on it. */
+    uint8_t *saved_stack;
 
-    // Ping pong contexts
-    PlatformContext suspend_context;
-    PlatformContext resume_context;
+    /** Size of the saved frames, in bytes. */
+    size_t saved_stack_size;
 
-    /** The current coroutine state. Schedulers should only have read-access to this. */
-    coro_state_t coro_state;
+    /** Context of the scheduler resuming the coroutine, held by coro_resume() on the
+     * scheduler's stack while the coroutine runs. */
+    PlatformContext *suspend_context;
 
-    /** For a non-running coroutine, this is the signal it last yielded with. */
-    CoroSignal yield_signal;
+    /** Context of the suspended coroutine. */
+    PlatformContext resume_context;
 };
 
 /*!
@@ -126,6 +190,24 @@ Coro *coro_create_static(Coro *coro, CoroEntrypoint entrypoint, void *context,
  */
 void coro_destroy_static(Coro *coro);
 
+/*!
+ * @brief Reinitialises a coroutine to run a new entrypoint, reusing its stack.
+ *
+ * Unlike creating a coroutine, the stack is not painted again, which makes reusing
+ * stacks cheap. As a consequence, stack usage diagnostics report the highest usage of
+ * any entrypoint that ran on the stack.
+ *
+ * @note The coroutine must not be managed by a scheduler.
+ *
+ * @param coro Coroutine to reinitialise, must be finished or not yet started.
+ * @param entrypoint Entrypoint function.
+ * @param context User context passed into the entrypoint function.
+ *
+ * @return pointer to the coroutine, or NULL if the coroutine is still running, or is
+ *      stackless.
+ */
+Coro *coro_reset(Coro *coro, CoroEntrypoint entrypoint, void *context);
+
 /*!
  * @brief Creates a coroutine with the specific stack and entrypoint.
  *
@@ -150,6 +232,36 @@ Coro *coro_create(CoroEntrypoint entrypoint, void *context, size_t stack_count);
  */
 void coro_free(Coro *coro);
 
+/*!
+ * @brief Measures the peak stack use of a coroutine.
+ *
+ * The stack is scanned for the deepest element no longer holding its initial paint.
+ * Elements written with the paint value are not detected, so the result is a lower
+ * bound. Use it with a margin to size stacks.
+ *
+ * @note Platforms defining PLATFORM_OWN_STACKS do not run coroutines on the provided
+ *      stack, the result is always 0 there.
+ *
+ * @param coro Coroutine to measure.
+ *
+ * @return Peak stack use in stack elements, or the usable stack size if the start
+ *      marker was overwritten.
+ */
+size_t coro_stack_high_water(Coro const *coro);
+
+/*!
+ * @brief Gets the runtime statistics of a coroutine.
+ *
+ * @note Only available when built with POCO_WITH_STATS.
+ *
+ * @param coro Coroutine to get the statistics of.
+ * @param stats Receives a copy of the statistics.
+ *
+ * @retval #RES_OK if the statistics were copied.
+ * @retval #RES_NOT_SUPPORTED if statistics are not recorded in this build.
+ */
+Result coro_get_stats(Coro const *coro, CoroStats *stats);
+
 /*!
  * @brief Called by the coroutine to yield control back to the scheduler.
  *
@@ -162,6 +274,21 @@ void coro_free(Coro *coro);
  */
 void coro_yield(void);
 
+/*!
+ * @brief Yields, asking the scheduler to resume the target coroutine next.
+ *
+ * Hands the processor straight to a coroutine this one has just made ready, such as the
+ * other end of a request and response pair, instead of waiting for a full sweep over
+ * the ready coroutines. The calling coroutine stays ready.
+ *
+ * @note The target must be managed by the same scheduler. If it is not ready, this
+ *      behaves as coro_yield(). The priority scheduler only runs the target next
+ *      within its priority, the work-stealing scheduler ignores the target.
+ *
+ * @param target Coroutine to resume next.
+ */
+void coro_yield_to(Coro *target);
+
 /*!
  * @brief Yield the coroutine with a specific delay.
  *
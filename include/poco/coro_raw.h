@@ -16,6 +16,26 @@ extern "C" {
 
 #include <poco/coro.h>
 
+/*!
+ * @brief Creates a coroutine on a stack allocated with platform_stack_alloc().
+ *
+ * Unlike coro_create_static(), stacks the platform commits lazily are not painted, as
+ * painting would commit every page. They only hold the end marker, overflows fault on
+ * the platform's guard page instead.
+ *
+ * @warning This is a special operation typically used by stack allocators.
+ *
+ * @param coro Coroutine to initialise.
+ * @param entrypoint Entrypoint function.
+ * @param context User context passed into the entrypoint function.
+ * @param stack Stack allocated with platform_stack_alloc().
+ * @param stack_count Number of platform specific elements in the stack.
+ *
+ * @return pointer to the coroutine, or NULL if a coroutine cannot be created.
+ */
+Coro *coro_create_platform_stack(Coro *coro, CoroEntrypoint entrypoint, void *context,
+                                 PlatformStackElement *stack, size_t stack_count);
+
 /*!
  * @brief Yield a coroutine with the provided signal source.
  *
@@ -54,6 +74,53 @@ void coro_yield_with_signal(CoroSignal signal);
  */
 bool coro_notify(Coro *coro, CoroEventSource const *event);
 
+/*!
+ * @brief Checks if an event would unblock the coroutine through one of its sinks.
+ *
+ * Unlike coro_notify(), this does not depend on, nor change, the coroutine's state.
+ * Only events with a subject can match. This is used by multi-threaded schedulers to
+ * detect events that happen while a coroutine is still on its way to block.
+ *
+ * @warning This is a special operation typically used for scheduler or communication
+ *          primitive development.
+ *
+ * @param coro Coroutine to check.
+ * @param event Event to check.
+ *
+ * @return True if the event matches one of the coroutine's sinks.
+ */
+bool coro_event_matches(Coro const *coro, CoroEventSource const *event);
+
+/*!
+ * @brief Unblocks a coroutine as if its primary sink had been triggered.
+ *
+ * Used to recover from lost events, the coroutine re-checks the condition it is
+ * waiting on, and blocks again if it is not met.
+ *
+ * @warning This is a special operation typically used for scheduler or communication
+ *          primitive development.
+ *
+ * @param coro Coroutine to wake.
+ *
+ * @return True if the coroutine's state has changed.
+ */
+bool coro_wake(Coro *coro);
+
+/*!
+ * @brief Notify a coroutine that the deadline of its delay sink has passed.
+ *
+ * This is used by schedulers that track timeouts as absolute deadlines, instead of
+ * delivering #CORO_EVTSRC_ELAPSED events.
+ *
+ * @warning This is a special operation typically used for scheduler or communication
+ *          primitive development.
+ *
+ * @param coro Coroutine to notify.
+ *
+ * @return True if the coroutine's state has changed.
+ */
+bool coro_notify_timeout(Coro *coro);
+
 /*!
  * @brief Resumes the coroutine from the point it last yielded.
  *
@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Lock-free multi-producer single-consumer ring of events.
+ *
+ * Used by schedulers to receive events from outside the scheduler, such as ISRs, signal
+ * handlers or other threads. Putting an event never blocks nor takes a lock, and only
+ * uses atomic operations, so it is safe from any context, including signal handlers.
+ * Only the scheduler (the single consumer) may get events.
+ *
+ * Each slot carries a sequence number, a producer claims a slot by advancing the head,
+ * then publishes the event by updating the slot's sequence number. The consumer only
+ * reads slots that have been published.
+ *
+ * Events are coalesced while they wait to be read. An event with the same type and
+ * subject as an event already in the ring is not placed again, as a single event wakes
+ * all the coroutines waiting on a subject. Elapsed events are merged, by adding their
+ * ticks together, and read as a single event. A burst of identical events therefore
+ * only uses one slot.
+ *
+ * When the ring is full, events are dropped and counted. The consumer is expected to
+ * check for dropped events with @ref event_ring_check_overflow, and recover from them,
+ * e.g. by waking all waiting coroutines.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <poco/intracoro.h>
+#include <poco/queue.h>
+#include <poco/result.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct event_ring_slot {
+    size_t sequence; /**< Position the slot is ready for, accessed atomically. */
+    CoroEventSource event;
+} EventRingSlot;
+
+typedef struct event_ring {
+    EventRingSlot *slots;
+    size_t mask; /**< Slot count - 1, the slot count is a power of 2. */
+    size_t head; /**< Next position to be claimed, accessed atomically. */
+    size_t tail; /**< Next position to be read, accessed atomically. */
+    /** Sum of the elapsed events waiting to be read, accessed atomically. */
+    PlatformTick elapsed_ticks;
+    size_t overflow_count; /**< Number of dropped events, accessed atomically. */
+    size_t checked_overflow_count; /**< Overflow count at the last check. */
+} EventRing;
+
+/*!
+ * @brief Create an event ring from statically allocated storage.
+ *
+ * @param ring Ring to initialise.
+ * @param slots Storage for the events.
+ * @param slot_count Number of slots, must be a power of 2.
+ *
+ * @return Pointer to the ring, or NULL if the slot count is not a power of 2.
+ */
+EventRing *event_ring_create_static(EventRing *ring, EventRingSlot *slots,
+                                    size_t slot_count);
+
+/*!
+ * @brief Places an event in the ring.
+ *
+ * Lock-free and async-signal-safe, may be called concurrently by any number of
+ * producers. Scans the events waiting to be read for a duplicate, so the cost grows
+ * with the number of unread events.
+ *
+ * @param ring Ring to place the event in.
+ * @param event Event to place.
+ *
+ * @retval #RES_OK if the event has been placed, or coalesced with a waiting event.
+ * @retval #RES_QUEUE_FULL if the ring is full, the event is dropped and counted.
+ */
+Result event_ring_put(EventRing *ring, CoroEventSource const *event);
+
+/*!
+ * @brief Takes the oldest published event from the ring.
+ *
+ * Merged elapsed events are taken first.
+ *
+ * @warning Must only be called by the consumer.
+ *
+ * @param ring Ring to take the event from.
+ * @param event Receives the event.
+ *
+ * @retval #RES_OK if an event has been taken.
+ * @retval #RES_QUEUE_EMPTY if there are no published events.
+ */
+Result event_ring_get(EventRing *ring, CoroEventSource *event);
+
+/*!
+ * @brief Checks if the ring has no published events.
+ *
+ * @warning Must only be called by the consumer.
+ *
+ * @param ring Ring to check.
+ *
+ * @return True if the next @ref event_ring_get would fail.
+ */
+bool event_ring_is_empty(EventRing const *ring);
+
+/*!
+ * @brief Gets the number of events dropped since the ring was created.
+ *
+ * @param ring Ring to check.
+ *
+ * @return Number of dropped events.
+ */
+size_t event_ring_overflow_count(EventRing const *ring);
+
+/*!
+ * @brief Checks if events have been dropped since the last check.
+ *
+ * @warning Must only be called by the consumer.
+ *
+ * @param ring Ring to check.
+ *
+ * @return True if events have been dropped since the last check.
+ */
+bool event_ring_check_overflow(EventRing *ring);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,160 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Intrusive doubly linked list.
+ *
+ * Lists are circular, with the list head acting as a sentinel node. This allows nodes
+ * to be unlinked in constant time without knowing which list they belong to.
+ *
+ * Schedulers use these to track coroutines without additional allocations.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*!
+ * @brief Gets the containing structure of an embedded list node.
+ *
+ * @param node Pointer to the embedded node.
+ * @param type Type of the containing structure.
+ * @param member Name of the node member within the containing structure.
+ */
+#define LIST_CONTAINER_OF(node, type, member)                                          \
+    ((type *)((char *)(node) - offsetof(type, member)))
+
+typedef struct list_node ListNode;
+
+/*!
+ * @brief Node (or list head) within an intrusive list.
+ *
+ * An unlinked node has both pointers set to NULL.
+ */
+struct list_node {
+    ListNode *next;
+    ListNode *prev;
+};
+
+/*!
+ * @brief Initialises a list head to an empty list.
+ *
+ * @param head List head to initialise.
+ */
+static inline void list_init(ListNode *head) {
+    head->next = head;
+    head->prev = head;
+}
+
+/*!
+ * @brief Initialises a node as not belonging to any list.
+ *
+ * @param node Node to initialise.
+ */
+static inline void list_node_init(ListNode *node) {
+    node->next = NULL;
+    node->prev = NULL;
+}
+
+/*!
+ * @brief Checks if the node is currently part of a list.
+ *
+ * @param node Node to check.
+ *
+ * @return True if the node is linked into a list.
+ */
+static inline bool list_node_is_linked(ListNode const *node) {
+    return node->next != NULL;
+}
+
+/*!
+ * @brief Checks if the list is empty.
+ *
+ * @param head List head to check.
+ *
+ * @return True if there are no nodes in the list.
+ */
+static inline bool list_is_empty(ListNode const *head) { return head->next == head; }
+
+/*!
+ * @brief Appends a node to the end of a list.
+ *
+ * @param head List to append to.
+ * @param node Node to append, must not already be in a list.
+ */
+static inline void list_push_back(ListNode *head, ListNode *node) {
+    node->next = head;
+    node->prev = head->prev;
+    head->prev->next = node;
+    head->prev = node;
+}
+
+/*!
+ * @brief Inserts a node at the front of a list.
+ *
+ * @param head List to insert into.
+ * @param node Node to insert, must not already be in a list.
+ */
+static inline void list_push_front(ListNode *head, ListNode *node) {
+    node->next = head->next;
+    node->prev = head;
+    head->next->prev = node;
+    head->next = node;
+}
+
+/*!
+ * @brief Removes a node from whichever list it is in.
+ *
+ * @param node Node to remove, must be linked.
+ */
+static inline void list_remove(ListNode *node) {
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    list_node_init(node);
+}
+
+/*!
+ * @brief Checks if a node is one of the first nodes of a list.
+ *
+ * @param head List to search.
+ * @param node Node to look for.
+ * @param count Number of nodes to search, from the front.
+ *
+ * @return True if the node is within the first count nodes of the list.
+ */
+static inline bool list_is_in_front(ListNode const *head, ListNode const *node,
+                                    size_t count) {
+    for (ListNode const *it = head->next; (it != head) && (count > 0); it = it->next) {
+        if (it == node) {
+            return true;
+        }
+        count--;
+    }
+    return false;
+}
+
+/*!
+ * @brief Removes the first node in the list.
+ *
+ * @param head List to remove from.
+ *
+ * @return The removed node, or NULL if the list is empty.
+ */
+static inline ListNode *list_pop_front(ListNode *head) {
+    if (list_is_empty(head)) {
+        return NULL;
+    }
+
+    ListNode *node = head->next;
+    list_remove(node);
+    return node;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -15,14 +15,25 @@ extern "C" {
 #include <poco/coro.h>
 #include <poco/event.h>
 #include <poco/intracoro.h>
+#include <poco/priority_queue.h>
 #include <poco/queue.h>
 #include <poco/result.h>
 #include <poco/scheduler.h>
 #include <poco/semaphore.h>
+#include <poco/shared_stack.h>
+#include <poco/spsc_queue.h>
+#include <poco/stack_pool.h>
+#include <poco/stackless.h>
+#include <poco/stats.h>
 #include <poco/stream.h>
+#include <poco/typed_queue.h>
 
 /* Also include all the known schedulers. */
+#include <poco/schedulers/priority.h>
 #include <poco/schedulers/round_robin.h>
+#ifdef POCO_WITH_THREADS
+#include <poco/schedulers/work_stealing.h>
+#endif
 
 #ifdef __cplusplus
 }
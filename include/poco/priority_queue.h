@@ -0,0 +1,200 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Coroutine aware priority queue implementation.
+ *
+ * Items are put with a priority, and got highest priority first. Items of the same
+ * priority are got in the order they were put. The queue is a binary heap, putting and
+ * getting an item are O(log n) and copy the item once.
+ *
+ * Blocked coroutines wait on the same events as a @ref queue, with the priority queue
+ * as the subject.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <poco/platform.h>
+#include <poco/queue.h>
+#include <poco/result.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*!
+ * @brief Heap node, refers to an item in the queue's item buffer.
+ *
+ * Nodes past the item count refer to the free item slots.
+ */
+typedef struct priority_queue_node {
+    uint32_t priority; /**< Priority of the item, higher values are got first. */
+    uint32_t sequence; /**< Order of the put, breaks ties between equal priorities. */
+    size_t slot;       /**< Index of the item in the item buffer. */
+} PriorityQueueNode;
+
+typedef struct priority_queue {
+    size_t volatile count;
+    uint32_t next_sequence;
+    PriorityQueueNode *nodes;
+    uint8_t *item_buffer;
+    size_t item_size;
+    size_t max_items;
+} PriorityQueue;
+
+/*!
+ * @brief Initialises a statically defined priority queue.
+ *
+ * @param queue Queue to initialise.
+ * @param num_items Number of items this queue will manage.
+ * @param item_size Size of an individual item, in bytes.
+ * @param item_buffer Buffer containing enough space for the items.
+ * @param nodes Buffer of num_items heap nodes.
+ *
+ * @return Pointer to the queue, or NULL if an error has occurred.
+ */
+PriorityQueue *priority_queue_create_static(PriorityQueue *queue, size_t num_items,
+                                            size_t item_size, uint8_t *item_buffer,
+                                            PriorityQueueNode *nodes);
+
+/*!
+ * @brief Creates a priority queue with a fixed number of elements.
+ *
+ * @param num_items Number of items this queue will manage.
+ * @param item_size Size of an individual item, in bytes.
+ *
+ * @return Pointer to the queue, or NULL if an error has occurred.
+ */
+PriorityQueue *priority_queue_create(size_t num_items, size_t item_size);
+
+/*!
+ * @brief Frees a previously created priority queue.
+ *
+ * @warning Freeing a statically created queue is undefined.
+ *
+ * @param queue Queue to free.
+ */
+void priority_queue_free(PriorityQueue *queue);
+
+/*!
+ * @brief Gets the number of items in a priority queue.
+ *
+ * @param queue Queue to check.
+ *
+ * @return Number of items in the queue.
+ */
+size_t priority_queue_item_count(PriorityQueue const *queue);
+
+/*!
+ * @brief Check if the priority queue is full.
+ *
+ * @param queue Queue to check.
+ *
+ * @return True if queue is full, false otherwise.
+ */
+bool priority_queue_is_full(PriorityQueue const *queue);
+
+/*!
+ * @brief Check if the priority queue is empty.
+ *
+ * @param queue Queue to check.
+ *
+ * @return True if queue is empty, false otherwise.
+ */
+bool priority_queue_is_empty(PriorityQueue const *queue);
+
+/*!
+ * @brief Puts an item into the priority queue from a coroutine.
+ *
+ * Items are copied into the queue. This operation blocks the calling coroutine until
+ * the item can be queued.
+ *
+ * @param queue Queue to put the item into.
+ * @param item Item to put into the queue.
+ * @param priority Priority of the item, higher values are got first.
+ * @param timeout Maximum time to wait before giving up.
+ *
+ * @retval #RES_OK on success.
+ * @retval #RES_TIMEOUT if the maximum time was awaited.
+ */
+Result priority_queue_put(PriorityQueue *queue, void const *item, uint32_t priority,
+                          PlatformTick timeout);
+
+/*!
+ * @brief Puts an item without waiting.
+ *
+ * @param queue Queue to put the item into.
+ * @param item Item to put into the queue.
+ * @param priority Priority of the item, higher values are got first.
+ *
+ * @retval #RES_OK Item has been queued.
+ * @retval #RES_QUEUE_FULL Queue is full, no item has been inserted.
+ * @retval #RES_NOTIFY_FAILED if the operation failed to notify the scheduler.
+ */
+Result priority_queue_put_no_wait(PriorityQueue *queue, void const *item,
+                                  uint32_t priority);
+
+/*!
+ * @brief Puts an item from an ISR.
+ *
+ * @param queue Queue to put the item into.
+ * @param item Item to put into the queue.
+ * @param priority Priority of the item, higher values are got first.
+ *
+ * @retval #RES_OK Item has been queued.
+ * @retval #RES_QUEUE_FULL Queue is full, no item has been inserted.
+ * @retval #RES_NOTIFY_FAILED if the operation failed to notify the scheduler.
+ */
+Result priority_queue_put_from_isr(PriorityQueue *queue, void const *item,
+                                   uint32_t priority);
+
+/*!
+ * @brief Gets the highest priority item from the queue from a coroutine.
+ *
+ * Items are copied out of the queue. This operation blocks the calling coroutine until
+ * an item is available.
+ *
+ * @param queue Queue to get the item from.
+ * @param item Item to get from the queue.
+ * @param priority Priority of the item, ignored if NULL.
+ * @param timeout Maximum time to wait before giving up.
+ *
+ * @retval #RES_OK on success.
+ * @retval #RES_TIMEOUT if the maximum time was awaited.
+ */
+Result priority_queue_get(PriorityQueue *queue, void *item, uint32_t *priority,
+                          PlatformTick timeout);
+
+/*!
+ * @brief Gets the highest priority item without waiting.
+ *
+ * @param queue Queue to get the item from.
+ * @param item Item to get from the queue, only valid if result was #RES_OK.
+ * @param priority Priority of the item, ignored if NULL.
+ *
+ * @retval #RES_OK An item has been taken.
+ * @retval #RES_QUEUE_EMPTY Queue has no items to get.
+ * @retval #RES_NOTIFY_FAILED if the operation failed to notify the scheduler.
+ */
+Result priority_queue_get_no_wait(PriorityQueue *queue, void *item, uint32_t *priority);
+
+/*!
+ * @brief Gets the highest priority item from an ISR.
+ *
+ * @param queue Queue to get the item from.
+ * @param item Item to get from the queue, only valid if result was #RES_OK.
+ * @param priority Priority of the item, ignored if NULL.
+ *
+ * @retval #RES_OK An item has been taken.
+ * @retval #RES_QUEUE_EMPTY Queue has no items to get.
+ * @retval #RES_NOTIFY_FAILED if the operation failed to notify the scheduler.
+ */
+Result priority_queue_get_from_isr(PriorityQueue *queue, void *item,
+                                   uint32_t *priority);
+
+#ifdef __cplusplus
+}
+#endif
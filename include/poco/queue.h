@@ -26,6 +26,9 @@ enum res_code_queue {
 
     /*! Attempted to put an item into a full queue. */
     RES_QUEUE_FULL = RES_CODE(RES_GROUP_QUEUE, 1),
+
+    /*! Attempted to commit or release without a reserved slot or a peeked item. */
+    RES_QUEUE_NOT_RESERVED = RES_CODE(RES_GROUP_QUEUE, 2),
 };
 
 typedef struct queue {
@@ -35,6 +38,12 @@ typedef struct queue {
     uint8_t *item_buffer;
     size_t item_size;
     size_t max_items;
+    // Reservation state, only accessed inside the critical section, or by the raw and
+    // ISR calls along with the indices.
+    bool put_reserved; /**< A slot is reserved by queue_put_reserve(). */
+    bool get_peeked;   /**< The oldest item is held by queue_get_peek(). */
+    bool put_waiting;  /**< A producer is blocked behind the reserved slot. */
+    bool get_waiting;  /**< A consumer is blocked behind the peeked item. */
 } Queue;
 
 /*!
@@ -176,6 +185,212 @@ Result queue_get_no_wait(Queue *queue, void *item);
  */
 Result queue_get_from_isr(Queue *queue, void *item);
 
+/*!
+ * @brief Puts several items into the queue from a coroutine.
+ *
+ * Items are copied into the queue with at most two copies, around the end of the
+ * queue's buffer, and waiting coroutines are notified once for the whole batch.
+ *
+ * This operation blocks the calling coroutine until at least min_count items can be
+ * queued, then queues as many items as fit.
+ *
+ * @param queue Queue to put the items into.
+ * @param items Array of items to put into the queue.
+ * @param item_count Number of items in the array. On return, the number of items
+ *      queued.
+ * @param min_count Minimum number of items to queue at once, from 1 up to the number
+ *      of items and the queue length.
+ * @param timeout Maximum time to wait before giving up.
+ *
+ * @retval #RES_OK on success.
+ * @retval #RES_TIMEOUT if the maximum time was awaited, no item has been queued.
+ * @retval #RES_INVALID_VALUE if min_count cannot be satisfied.
+ */
+Result queue_put_many(Queue *queue, void const *items, size_t *item_count,
+                      size_t min_count, PlatformTick timeout);
+
+/*!
+ * @brief Puts as many items as fit without waiting.
+ *
+ * @param queue Queue to put the items into.
+ * @param items Array of items to put into the queue.
+ * @param item_count Number of items in the array. On return, the number of items
+ *      queued.
+ *
+ * @retval #RES_OK Items have been queued.
+ * @retval #RES_QUEUE_FULL Queue is full, no item has been inserted.
+ * @retval #RES_NOTIFY_FAILED if the operation failed to notify the scheduler.
+ */
+Result queue_put_many_no_wait(Queue *queue, void const *items, size_t *item_count);
+
+/*!
+ * @brief Puts as many items as fit from an ISR.
+ *
+ * @param queue Queue to put the items into.
+ * @param items Array of items to put into the queue.
+ * @param item_count Number of items in the array. On return, the number of items
+ *      queued.
+ *
+ * @retval #RES_OK Items have been queued.
+ * @retval #RES_QUEUE_FULL Queue is full, no item has been inserted.
+ * @retval #RES_NOTIFY_FAILED if the operation failed to notify the scheduler.
+ */
+Result queue_put_many_from_isr(Queue *queue, void const *items, size_t *item_count);
+
+/*!
+ * @brief Gets several items from the queue from a coroutine.
+ *
+ * Items are copied out of the queue with at most two copies, around the end of the
+ * queue's buffer, and waiting coroutines are notified once for the whole batch.
+ *
+ * This operation blocks the calling coroutine until at least min_count items are
+ * queued, then takes as many items as are queued.
+ *
+ * @param queue Queue to get the items from.
+ * @param items Array to store the items into.
+ * @param item_count Number of items the array can store. On return, the number of
+ *      items taken.
+ * @param min_count Minimum number of items to take at once, from 1 up to the size of
+ *      the array and the queue length.
+ * @param timeout Maximum time to wait before giving up.
+ *
+ * @retval #RES_OK on success.
+ * @retval #RES_TIMEOUT if the maximum time was awaited, no item has been taken.
+ * @retval #RES_INVALID_VALUE if min_count cannot be satisfied.
+ */
+Result queue_get_many(Queue *queue, void *items, size_t *item_count, size_t min_count,
+                      PlatformTick timeout);
+
+/*!
+ * @brief Gets as many items as are queued without waiting.
+ *
+ * @param queue Queue to get the items from.
+ * @param items Array to store the items into.
+ * @param item_count Number of items the array can store. On return, the number of
+ *      items taken.
+ *
+ * @retval #RES_OK Items have been taken.
+ * @retval #RES_QUEUE_EMPTY Queue has no items to get.
+ * @retval #RES_NOTIFY_FAILED if the operation failed to notify the scheduler.
+ */
+Result queue_get_many_no_wait(Queue *queue, void *items, size_t *item_count);
+
+/*!
+ * @brief Gets as many items as are queued from an ISR.
+ *
+ * @param queue Queue to get the items from.
+ * @param items Array to store the items into.
+ * @param item_count Number of items the array can store. On return, the number of
+ *      items taken.
+ *
+ * @retval #RES_OK Items have been taken.
+ * @retval #RES_QUEUE_EMPTY Queue has no items to get.
+ * @retval #RES_NOTIFY_FAILED if the operation failed to notify the scheduler.
+ */
+Result queue_get_many_from_isr(Queue *queue, void *items, size_t *item_count);
+
+/*!
+ * @brief Reserves the next slot of the queue from a coroutine, to fill it in place.
+ *
+ * The item is only queued by queue_put_commit(), avoiding a copy of large items. A
+ * single slot is reserved at a time, other producers see the queue as full until the
+ * reserved slot is committed.
+ *
+ * This operation blocks the calling coroutine until a slot can be reserved.
+ *
+ * @param queue Queue to reserve a slot of.
+ * @param[out] slot Reserved slot, of the queue's item size.
+ * @param timeout Maximum time to wait before giving up.
+ *
+ * @retval #RES_OK A slot has been reserved.
+ * @retval #RES_TIMEOUT if the maximum time was awaited.
+ */
+Result queue_put_reserve(Queue *queue, void **slot, PlatformTick timeout);
+
+/*!
+ * @brief Reserves the next slot of the queue without waiting.
+ *
+ * @param queue Queue to reserve a slot of.
+ * @param[out] slot Reserved slot, only valid if result was #RES_OK.
+ *
+ * @retval #RES_OK A slot has been reserved.
+ * @retval #RES_QUEUE_FULL Queue is full, or a slot is already reserved.
+ */
+Result queue_put_reserve_no_wait(Queue *queue, void **slot);
+
+/*!
+ * @brief Queues the reserved slot from a coroutine.
+ *
+ * @param queue Queue the slot was reserved from.
+ *
+ * @retval #RES_OK The item has been queued.
+ * @retval #RES_QUEUE_NOT_RESERVED No slot is reserved.
+ * @retval #RES_NOTIFY_FAILED if the operation failed to notify the scheduler.
+ */
+Result queue_put_commit(Queue *queue);
+
+/*!
+ * @brief Queues the reserved slot without yielding.
+ *
+ * @param queue Queue the slot was reserved from.
+ *
+ * @retval #RES_OK The item has been queued.
+ * @retval #RES_QUEUE_NOT_RESERVED No slot is reserved.
+ * @retval #RES_NOTIFY_FAILED if the operation failed to notify the scheduler.
+ */
+Result queue_put_commit_no_wait(Queue *queue);
+
+/*!
+ * @brief Peeks at the oldest item of the queue from a coroutine, to use it in place.
+ *
+ * The item stays in the queue until queue_get_release(), avoiding a copy of large
+ * items. A single item is peeked at a time, other consumers see the queue as empty
+ * until the peeked item is released.
+ *
+ * This operation blocks the calling coroutine until an item can be peeked.
+ *
+ * @param queue Queue to peek at.
+ * @param[out] item Oldest item, of the queue's item size.
+ * @param timeout Maximum time to wait before giving up.
+ *
+ * @retval #RES_OK An item has been peeked.
+ * @retval #RES_TIMEOUT if the maximum time was awaited.
+ */
+Result queue_get_peek(Queue *queue, void **item, PlatformTick timeout);
+
+/*!
+ * @brief Peeks at the oldest item of the queue without waiting.
+ *
+ * @param queue Queue to peek at.
+ * @param[out] item Oldest item, only valid if result was #RES_OK.
+ *
+ * @retval #RES_OK An item has been peeked.
+ * @retval #RES_QUEUE_EMPTY Queue is empty, or an item is already peeked.
+ */
+Result queue_get_peek_no_wait(Queue *queue, void **item);
+
+/*!
+ * @brief Removes the peeked item from the queue from a coroutine.
+ *
+ * @param queue Queue the item was peeked from.
+ *
+ * @retval #RES_OK The item has been removed.
+ * @retval #RES_QUEUE_NOT_RESERVED No item is peeked.
+ * @retval #RES_NOTIFY_FAILED if the operation failed to notify the scheduler.
+ */
+Result queue_get_release(Queue *queue);
+
+/*!
+ * @brief Removes the peeked item from the queue without yielding.
+ *
+ * @param queue Queue the item was peeked from.
+ *
+ * @retval #RES_OK The item has been removed.
+ * @retval #RES_QUEUE_NOT_RESERVED No item is peeked.
+ * @retval #RES_NOTIFY_FAILED if the operation failed to notify the scheduler.
+ */
+Result queue_get_release_no_wait(Queue *queue);
+
 #ifdef __cplusplus
 }
 #endif
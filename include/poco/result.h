@@ -61,10 +61,14 @@ enum res_codes_general {
     /*!
      * A scheduler notification failed.
      *
-     * @warning This is a critical failure and indicates the number of events the
-     * scheduler has been configured with is not sufficient.
+     * @warning This indicates the number of events the scheduler has been configured
+     * with is not sufficient. The built-in schedulers recover by waking all waiting
+     * coroutines, at the cost of spurious wake-ups.
      */
     RES_NOTIFY_FAILED = RES_CODE(RES_GROUP_GENERAL, 6),
+
+    /*! Operation is not available in this build. */
+    RES_NOT_SUPPORTED = RES_CODE(RES_GROUP_GENERAL, 7),
 };
 
 #ifdef __cplusplus
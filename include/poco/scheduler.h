@@ -23,6 +23,25 @@ extern "C" {
 #include <poco/intracoro.h>
 #include <poco/result.h>
 
+#ifndef SCHEDULER_MAX_EXTERNAL_EVENT_COUNT
+/*!
+ * @brief Number of external events a dynamically created scheduler can hold between
+ * each pass, must be a power of 2.
+ *
+ * Statically created schedulers are given their event storage, and can use any power
+ * of 2.
+ */
+#define SCHEDULER_MAX_EXTERNAL_EVENT_COUNT (16)
+#endif
+
+#ifndef SCHEDULER_HANDOFF_LIMIT
+/*!
+ * @brief Most coroutines resumed in a row by handoff, before the other ready coroutines
+ * get their turn.
+ */
+#define SCHEDULER_HANDOFF_LIMIT (16)
+#endif
+
 typedef struct scheduler Scheduler;
 
 /*!
@@ -92,6 +111,34 @@ typedef Result (*SchedulerNotifyFromISR)(Scheduler *scheduler,
 
 typedef Coro *(*SchedulerGetCurrentCoroutine)(Scheduler *scheduler);
 
+/*!
+ * @brief Function prototype called for each coroutine of a scheduler.
+ *
+ * @param coro Coroutine managed by the scheduler.
+ * @param context User context passed to the iteration.
+ */
+typedef void (*SchedulerCoroutineVisitor)(Coro *coro, void *context);
+
+/*!
+ * @brief Function prototype calling the visitor for each coroutine of the scheduler.
+ *
+ * @param scheduler Scheduler to iterate.
+ * @param visitor Function called for each coroutine.
+ * @param context User context passed to the visitor.
+ */
+typedef void (*SchedulerForEachCoroutine)(Scheduler *scheduler,
+                                          SchedulerCoroutineVisitor visitor,
+                                          void *context);
+
+/*!
+ * @brief Function prototype called with each finished coroutine, once removed from its
+ * scheduler.
+ *
+ * @param coro Finished coroutine, no longer referenced by the scheduler.
+ * @param context User context given with the reaper.
+ */
+typedef void (*SchedulerReaper)(Coro *coro, void *context);
+
 /*!
  * @brief Scheduler common interface.
  */
@@ -100,8 +147,21 @@ struct scheduler {
     SchedulerNotify notify;
     SchedulerNotifyFromISR notify_from_isr;
     SchedulerGetCurrentCoroutine get_current_coroutine;
+    SchedulerForEachCoroutine for_each_coroutine;
+#ifdef POCO_WITH_STATS
+    SchedulerStats stats; /**< Runtime statistics, see scheduler_get_stats(). */
+#endif
 };
 
+/*!
+ * @brief Stack use of a coroutine, as listed in a stack report.
+ */
+typedef struct coro_stack_usage {
+    Coro const *coro;
+    size_t stack_size; /**< Stack size, in stack elements. */
+    size_t high_water; /**< Peak stack use, in stack elements. */
+} CoroStackUsage;
+
 /*!
  * @brief Runs the scheduler until completion.
  *
@@ -184,6 +244,55 @@ static inline Coro *scheduler_get_current_coroutine(Scheduler *scheduler) {
     return scheduler->get_current_coroutine(scheduler);
 }
 
+/*!
+ * @brief Calls the visitor for each coroutine managed by the scheduler.
+ *
+ * @warning The visitor must not add nor remove coroutines.
+ *
+ * @param scheduler Scheduler to iterate.
+ * @param visitor Function called for each coroutine.
+ * @param context User context passed to the visitor.
+ */
+static inline void scheduler_for_each_coroutine(Scheduler *scheduler,
+                                                SchedulerCoroutineVisitor visitor,
+                                                void *context) {
+    scheduler->for_each_coroutine(scheduler, visitor, context);
+}
+
+/*!
+ * @brief Lists the peak stack use of each coroutine managed by the scheduler.
+ *
+ * Intended to size stacks from measurements, see coro_stack_high_water().
+ *
+ * @warning For multi-threaded schedulers, the report is only accurate once the
+ *      scheduler has stopped.
+ *
+ * @param scheduler Scheduler to report on.
+ * @param usages Receives the stack use of up to max_usages coroutines.
+ * @param max_usages Number of entries usages can hold.
+ *
+ * @return Number of coroutines managed by the scheduler, which may exceed max_usages.
+ */
+size_t scheduler_stack_report(Scheduler *scheduler, CoroStackUsage *usages,
+                              size_t max_usages);
+
+/*!
+ * @brief Gets the runtime statistics of a scheduler.
+ *
+ * Statistics of each coroutine are available from coro_get_stats().
+ *
+ * @note Only available when built with POCO_WITH_STATS.
+ * @warning For multi-threaded schedulers, the statistics are only accurate once the
+ *      scheduler has stopped.
+ *
+ * @param scheduler Scheduler to get the statistics of.
+ * @param stats Receives a copy of the statistics.
+ *
+ * @retval #RES_OK if the statistics were copied.
+ * @retval #RES_NOT_SUPPORTED if statistics are not recorded in this build.
+ */
+Result scheduler_get_stats(Scheduler const *scheduler, SchedulerStats *stats);
+
 #ifdef __cplusplus
 }
 #endif
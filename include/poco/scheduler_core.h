@@ -0,0 +1,247 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief State and logic shared by the schedulers.
+ *
+ * The core owns the task table, the blocked tasks, their timeouts and the events
+ * notified from outside the scheduler. Each scheduler only decides the order ready
+ * tasks are resumed in, through a @ref scheduler_core_policy.
+ *
+ * Single threaded schedulers run their whole scheduling loop with
+ * scheduler_core_run(). Other schedulers only use the building blocks, and provide
+ * their own loop.
+ *
+ * @warning This is typically used for scheduler development.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <poco/coro.h>
+#include <poco/event_ring.h>
+#include <poco/intracoro.h>
+#include <poco/list.h>
+#include <poco/platform.h>
+#include <poco/result.h>
+#include <poco/scheduler.h>
+#include <poco/timer_heap.h>
+#include <poco/wait_table.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct scheduler_core SchedulerCore;
+
+/*!
+ * @brief Function prototype placing a ready task in the ready list(s) of a scheduler.
+ *
+ * @param core Core of the scheduler.
+ * @param task Task to place, not part of any list.
+ */
+typedef void (*SchedulerCoreAddTask)(SchedulerCore *core, Coro *task);
+
+/*!
+ * @brief Function prototype taking the next task to resume out of the ready list(s).
+ *
+ * Tasks placed by the add next task function count towards the handoff streak of the
+ * core, the other tasks reset it.
+ *
+ * @param core Core of the scheduler.
+ *
+ * @return Task to resume, or NULL if no task is ready.
+ */
+typedef Coro *(*SchedulerCoreGetTask)(SchedulerCore *core);
+
+/*!
+ * @brief Function prototype removing a task from the ready list(s) of a scheduler.
+ *
+ * @param core Core of the scheduler.
+ * @param task Ready task to remove, part of a ready list.
+ */
+typedef void (*SchedulerCoreRemoveTask)(SchedulerCore *core, Coro *task);
+
+/*!
+ * @brief Function prototype called with each event, once the waiting tasks are updated.
+ *
+ * Lets multi-threaded schedulers check the event against tasks that are still running.
+ *
+ * @param core Core of the scheduler.
+ * @param event Event notified, or NULL if external events were dropped.
+ */
+typedef void (*SchedulerCoreEventHook)(SchedulerCore *core,
+                                       CoroEventSource const *event);
+
+/*!
+ * @brief Ready list policy of a scheduler.
+ */
+typedef struct scheduler_core_policy {
+    SchedulerCoreAddTask add_ready_task; /**< Places a task to be resumed last. */
+    /** Places a task to be resumed next, only needed by scheduler_core_run(). */
+    SchedulerCoreAddTask add_next_task;
+    /** Takes the next task, only needed by scheduler_core_run(). */
+    SchedulerCoreGetTask get_next_ready_task;
+    /** Removes a ready task, only needed by scheduler_core_run() and
+     * scheduler_core_remove_coro(). */
+    SchedulerCoreRemoveTask remove_ready_task;
+    SchedulerCoreEventHook event_hook; /**< Called with each event, if set. */
+} SchedulerCorePolicy;
+
+struct scheduler_core {
+    Scheduler scheduler; /**< Scheduler interface, first so cores can be cast to it. */
+    SchedulerCorePolicy const *policy;
+    Coro **tasks;           /**< Task table, tasks are packed at the front. */
+    size_t max_tasks_count; /**< Maximum number of tasks the task array can store. */
+    size_t all_tasks;       /**< Number of actual tasks in the task list. */
+    size_t finished_tasks;
+    Coro *current_task;
+    SchedulerReaper reaper; /**< Called with finished tasks, if set. */
+    void *reaper_context;   /**< User context passed to the reaper. */
+    bool handoff;           /**< Resume the task woken by the running task next. */
+    size_t handoff_streak;  /**< Tasks resumed in a row by handoff. */
+    WaitTable wait_table;   /**< Blocked tasks, by the subject they are waiting on. */
+    /** Events notified from outside the scheduler. */
+    EventRing external_events;
+    TimerHeap timers;           /**< Deadlines of blocked tasks with a timeout. */
+    PlatformTick current_ticks; /**< Tick value sampled during the last pass. */
+    PlatformIdle idle;          /**< Blocks the scheduler while nothing is ready. */
+};
+
+/*!
+ * @brief Initialises the core of a scheduler.
+ *
+ * The tasks are packed at the front of the task table, and the ready ones are placed
+ * with the policy. The scheduler interface runs scheduler_core_run(), and queues all
+ * events in the external event ring, schedulers can override it once initialised.
+ *
+ * @param core Core to initialise.
+ * @param policy Ready list policy of the scheduler, must outlive the core.
+ * @param coro_list List of coroutines to schedule, owned by the core once initialised.
+ * @param num_coros Number of coroutines in the list.
+ * @param event_slots Storage for external events, owned by the core once initialised.
+ * @param event_slot_count Number of external events that can be held between each
+ *      pass, must be a power of 2.
+ *
+ * @retval #RES_OK on success.
+ * @retval #RES_INVALID_VALUE if the event slot count is not a power of 2.
+ */
+Result scheduler_core_init(SchedulerCore *core, SchedulerCorePolicy const *policy,
+                           Coro **coro_list, size_t num_coros,
+                           EventRingSlot *event_slots, size_t event_slot_count);
+
+/*!
+ * @brief Releases the platform resources of a core, not its storage.
+ *
+ * @param core Core to destroy.
+ */
+void scheduler_core_destroy(SchedulerCore *core);
+
+/*!
+ * @brief Adds a coroutine to the task table, placing it with the policy if ready.
+ *
+ * @param core Core to add the coroutine to.
+ * @param coro Coroutine to add.
+ *
+ * @retval #RES_OK on success.
+ * @retval #RES_NO_MEM if the task table is full.
+ */
+Result scheduler_core_add_coro(SchedulerCore *core, Coro *coro);
+
+/*!
+ * @brief Removes a coroutine from the task table, and from any ready or wait list.
+ *
+ * @param core Core to remove the coroutine from.
+ * @param coro Coroutine to remove, ignored if not managed by the core.
+ */
+void scheduler_core_remove_coro(SchedulerCore *core, Coro const *coro);
+
+/*!
+ * @brief Counts the finished tasks, and samples the ticks, before running.
+ *
+ * @param core Core to start.
+ */
+void scheduler_core_start(SchedulerCore *core);
+
+/*!
+ * @brief Blocks a task, until the event or the timeout of its sinks.
+ *
+ * @param core Core to block the task in.
+ * @param task Task which has just yielded blocked.
+ */
+void scheduler_core_block_task(SchedulerCore *core, Coro *task);
+
+/*!
+ * @brief Unblocks the tasks waiting on the event, and places them with the policy.
+ *
+ * @param core Core to update.
+ * @param event Event to notify.
+ * @param handoff Place the first unblocked task to be resumed next.
+ *
+ * @return Number of tasks unblocked.
+ */
+size_t scheduler_core_update_waiting_tasks(SchedulerCore *core,
+                                           CoroEventSource const *event, bool handoff);
+
+/*!
+ * @brief Unblocks the tasks whose timeout has passed, and places them with the policy.
+ *
+ * @param core Core to update.
+ */
+void scheduler_core_update_expired_tasks(SchedulerCore *core);
+
+/*!
+ * @brief Updates the waiting tasks with the events notified from outside the scheduler.
+ *
+ * Only the events present when starting are handled, so producers cannot keep the
+ * scheduler here. If events were dropped as the ring was full, the tasks they were
+ * meant for are unknown, so all waiting tasks are woken to check their condition again.
+ *
+ * @param core Core to update.
+ */
+void scheduler_core_update_external_events(SchedulerCore *core);
+
+/*!
+ * @brief Gets the ticks until the next timeout is due.
+ *
+ * @param core Core to check.
+ *
+ * @return Ticks until the earliest deadline, 0 if already due, or
+ *      #PLATFORM_TICKS_FOREVER if no blocked task has a timeout.
+ */
+PlatformTick scheduler_core_next_timeout(SchedulerCore const *core);
+
+/*!
+ * @brief Queues an event from an ISR, and wakes the scheduler up.
+ *
+ * @param core Core to notify.
+ * @param event Event to notify.
+ *
+ * @retval #RES_OK on success.
+ * @retval #RES_NOTIFY_FAILED if the event was dropped.
+ */
+Result scheduler_core_notify_from_isr(SchedulerCore *core,
+                                      CoroEventSource const *event);
+
+/*!
+ * @brief Queues an event, handled by the next pass of the scheduler.
+ *
+ * @param core Core to notify.
+ * @param event Event to notify.
+ *
+ * @retval #RES_OK on success.
+ * @retval #RES_NOTIFY_FAILED if the event was dropped.
+ */
+Result scheduler_core_notify(SchedulerCore *core, CoroEventSource const *event);
+
+/*!
+ * @brief Runs the tasks of a single threaded scheduler until they are all finished.
+ *
+ * @param core Core to run, all the policy functions must be set.
+ */
+void scheduler_core_run(SchedulerCore *core);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief A fixed priority scheduler.
+ *
+ * Each time a coroutine yields, the scheduler resumes the oldest ready coroutine of the
+ * highest ready priority. Coroutines of the same priority are scheduled round-robin.
+ *
+ * Lower priority coroutines only run when no higher priority coroutine is ready, which
+ * allows latency critical coroutines to run ahead of bulk work as soon as the running
+ * coroutine yields.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <poco/coro.h>
+#include <poco/event_ring.h>
+#include <poco/intracoro.h>
+#include <poco/list.h>
+#include <poco/scheduler.h>
+#include <poco/scheduler_core.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** Number of priority levels, priorities range from 0 (lowest) to count - 1. */
+#define PRIORITY_SCHEDULER_LEVEL_COUNT (32)
+
+typedef struct priority_scheduler {
+    SchedulerCore core; /**< Task table, blocked tasks and external events. */
+    /** Tasks at the front of each ready list, placed there by handoff. */
+    uint8_t handoff_counts[PRIORITY_SCHEDULER_LEVEL_COUNT];
+    /** Bit N is set if the ready list of priority N is in use. */
+    uint32_t ready_levels;
+    /** Ready tasks, by priority. */
+    ListNode ready_tasks[PRIORITY_SCHEDULER_LEVEL_COUNT];
+} PriorityScheduler;
+
+/*!
+ * @brief Create a priority scheduler.
+ *
+ * @param coro_list List of coroutines to schedule.
+ * @param priorities Priority of each coroutine in the list, higher values run first.
+ * @param num_coros Number of coroutines in the list.
+ *
+ * @return Pointer to the scheduler, or NULL on error.
+ */
+Scheduler *priority_scheduler_create(Coro *const *coro_list, uint8_t const *priorities,
+                                     size_t num_coros);
+
+/*!
+ * @brief Create a priority scheduler from statically allocated storage.
+ *
+ * @param scheduler Scheduler to initialise.
+ * @param coro_list List of coroutines to schedule, owned by the scheduler once created.
+ * @param priorities Priority of each coroutine in the list, higher values run first.
+ * @param num_coros Number of coroutines in the list.
+ * @param event_slots Storage for external events, owned by the scheduler once created.
+ * @param event_slot_count Number of external events that can be held between each
+ *      pass, must be a power of 2.
+ *
+ * @return Pointer to the scheduler, or NULL if any priority is out of range or the
+ *      event slot count is not a power of 2.
+ */
+Scheduler *priority_scheduler_create_static(PriorityScheduler *scheduler,
+                                            Coro **coro_list,
+                                            uint8_t const *priorities, size_t num_coros,
+                                            EventRingSlot *event_slots,
+                                            size_t event_slot_count);
+
+/*!
+ * @brief Frees a dynamically allocated scheduler.
+ *
+ * @param scheduler Scheduler to free, must have been created from @ref
+ *      priority_scheduler_create.
+ */
+void priority_scheduler_free(PriorityScheduler *scheduler);
+
+/*!
+ * @brief Add a coroutine to the scheduler, in constant time.
+ *
+ * @note As with the round-robin scheduler, this will only use empty slots.
+ *
+ * @param scheduler Scheduler to add to.
+ * @param coro Coroutine to add.
+ * @param priority Priority of the coroutine, higher values run first.
+ *
+ * @retval #RES_OK if the coroutine has been added
+ * @retval #RES_INVALID_VALUE if the priority is out of range
+ * @retval #RES_NO_MEM if there was no space for the coroutine
+ */
+Result priority_scheduler_add_coro(PriorityScheduler *scheduler, Coro *coro,
+                                   uint8_t priority);
+
+/*!
+ * @brief Remove a coroutine from the scheduler, in constant time.
+ *
+ * Coroutines not managed by the scheduler are ignored.
+ *
+ * @param scheduler Scheduler to remove from.
+ * @param coro Coroutine to remove.
+ */
+void priority_scheduler_remove_coro(PriorityScheduler *scheduler, Coro const *coro);
+
+/*!
+ * @brief Sets the function finished coroutines are handed over to.
+ *
+ * Behaves as round_robin_scheduler_set_reaper().
+ *
+ * @warning Reaped coroutines must not be joined, as the reaper may free them before
+ *      the joining coroutine resumes.
+ *
+ * @param scheduler Scheduler to set the reaper of.
+ * @param reaper Function called with each finished coroutine, or NULL to keep finished
+ *      coroutines in the scheduler.
+ * @param context User context passed to the reaper.
+ */
+void priority_scheduler_set_reaper(PriorityScheduler *scheduler, SchedulerReaper reaper,
+                                   void *context);
+
+/*!
+ * @brief Enables resuming woken coroutines straight after the coroutine waking them.
+ *
+ * Behaves as round_robin_scheduler_set_handoff(), within the priority of the woken
+ * coroutine. Higher priority coroutines still run first.
+ *
+ * @param scheduler Scheduler to configure.
+ * @param enabled True to enable handoff.
+ */
+void priority_scheduler_set_handoff(PriorityScheduler *scheduler, bool enabled);
+
+#ifdef __cplusplus
+}
+#endif
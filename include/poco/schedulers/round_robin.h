@@ -12,26 +12,17 @@ extern "C" {
 #endif
 
 #include <poco/coro.h>
+#include <poco/event_ring.h>
 #include <poco/intracoro.h>
-#include <poco/platform.h>
-#include <poco/queue.h>
+#include <poco/list.h>
 #include <poco/scheduler.h>
+#include <poco/scheduler_core.h>
 #include <stddef.h>
 
-/** Maximum number of external events a scheduler can handle between each yield. */
-#define SCHEDULER_MAX_EXTERNAL_EVENT_COUNT (16)
-
 typedef struct round_robin_scheduler {
-    Scheduler scheduler;
-    Coro **tasks;
-    size_t max_tasks_count; /**< Maximum number of tasks the task array can store. */
-    size_t all_tasks;       /**<* Number of actual tasks in the task list. */
-    size_t finished_tasks;
-    Coro *current_task;
-    size_t next_task_index; /**< index to check next when performing a context switch */
-    Queue event_queue;
-    CoroEventSource external_events[SCHEDULER_MAX_EXTERNAL_EVENT_COUNT];
-    PlatformTick previous_ticks;
+    SchedulerCore core;   /**< Task table, blocked tasks and external events. */
+    size_t handoff_count; /**< Tasks at the front of the ready list, from handoff. */
+    ListNode ready_tasks; /**< Tasks ready to run, in the order they will be resumed. */
 } RoundRobinScheduler;
 
 /*!
@@ -44,8 +35,22 @@ typedef struct round_robin_scheduler {
  */
 Scheduler *round_robin_scheduler_create(Coro *const *coro_list, size_t num_coros);
 
+/*!
+ * @brief Create a basic scheduler from statically allocated storage.
+ *
+ * @param scheduler Scheduler to initialise.
+ * @param coro_list List of coroutines to schedule, owned by the scheduler once created.
+ * @param num_coros Number of coroutines in the list.
+ * @param event_slots Storage for external events, owned by the scheduler once created.
+ * @param event_slot_count Number of external events that can be held between each
+ *      pass, must be a power of 2.
+ *
+ * @return Pointer to the scheduler, or NULL on error.
+ */
 Scheduler *round_robin_scheduler_create_static(RoundRobinScheduler *scheduler,
-                                               Coro **coro_list, size_t num_coros);
+                                               Coro **coro_list, size_t num_coros,
+                                               EventRingSlot *event_slots,
+                                               size_t event_slot_count);
 
 /*!
  * @brief Frees a dynamically allocated scheduler.
@@ -56,11 +61,11 @@ Scheduler *round_robin_scheduler_create_static(RoundRobinScheduler *scheduler,
 void round_round_robin_scheduler_free(RoundRobinScheduler *scheduler);
 
 /*!
- * @brief Add a coroutine to the scheduler.
+ * @brief Add a coroutine to the scheduler, in constant time.
  *
- * @note This will only use empty slots. If a coroutine is finished, its slow must be
- *      explicitly cleared by the caller. This is to guarantee to the caller that the
- *      scheduler holds the reference (until being told not to).
+ * @note This will only use empty slots. Unless a reaper is set, a finished coroutine
+ *      keeps its slot until explicitly removed by the caller. This is to guarantee to
+ *      the caller that the scheduler holds the reference (until being told not to).
  *
  * @param scheduler
  * @param coro
@@ -69,9 +74,56 @@ void round_round_robin_scheduler_free(RoundRobinScheduler *scheduler);
  * @retval #RES_NO_MEM if there was no space for the coroutine
  */
 Result round_robin_scheduler_add_coro(RoundRobinScheduler *scheduler, Coro *coro);
+
+/*!
+ * @brief Remove a coroutine from the scheduler, in constant time.
+ *
+ * Coroutines not managed by the scheduler are ignored.
+ *
+ * @param scheduler Scheduler to remove from.
+ * @param coro Coroutine to remove.
+ */
 void round_robin_scheduler_remove_coro(RoundRobinScheduler *scheduler,
                                        Coro const *coro);
 
+/*!
+ * @brief Sets the function finished coroutines are handed over to.
+ *
+ * Once set, coroutines are removed from the scheduler as soon as they finish, then
+ * passed to the reaper, which may free them or return them to a stack pool, see
+ * stack_pool_reap().
+ *
+ * @warning Reaped coroutines must not be joined, as the reaper may free them before
+ *      the joining coroutine resumes.
+ *
+ * @param scheduler Scheduler to set the reaper of.
+ * @param reaper Function called with each finished coroutine, or NULL to keep finished
+ *      coroutines in the scheduler.
+ * @param context User context passed to the reaper.
+ */
+void round_robin_scheduler_set_reaper(RoundRobinScheduler *scheduler,
+                                      SchedulerReaper reaper, void *context);
+
+/*!
+ * @brief Enables resuming woken coroutines straight after the coroutine waking them.
+ *
+ * By default, a coroutine woken by another coroutine, for example by putting an item in
+ * the queue it waits on, joins the back of the ready list, and so does the coroutine
+ * notifying. With handoff enabled, the first coroutine woken by the event is resumed
+ * next, followed by the coroutine notifying, so request and response pairs keep a
+ * constant latency however many coroutines are ready. A coroutine notifying an event
+ * nobody waits on keeps no turn, and joins the back of the ready list.
+ *
+ * After #SCHEDULER_HANDOFF_LIMIT coroutines resumed in a row by handoff, the other
+ * ready coroutines get their turn.
+ *
+ * @note Events from outside the scheduler and timeouts never hand off.
+ *
+ * @param scheduler Scheduler to configure.
+ * @param enabled True to enable handoff.
+ */
+void round_robin_scheduler_set_handoff(RoundRobinScheduler *scheduler, bool enabled);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief A multi-threaded work-stealing scheduler.
+ *
+ * Runs coroutines on a pool of worker threads. Each worker has its own ready list, and
+ * takes ready coroutines from its peers when its own list is empty, spreading the
+ * coroutines across all workers. Coroutines can migrate between workers each time they
+ * yield.
+ *
+ * Blocked coroutines and their timeouts are shared by all workers, kept in a scheduler
+ * core protected by a scheduler wide lock. Events notified from ISRs are queued in the
+ * core's lock-free event ring instead, and handled by the next worker to take the lock.
+ *
+ * @note Only available on the unix platform, when built with POCO_WITH_THREADS.
+ *
+ * @warning Coroutines must not cache thread specific state (e.g. thread-local
+ *          variables) across yields, as they may resume on a different thread.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <poco/coro.h>
+#include <poco/event_ring.h>
+#include <poco/intracoro.h>
+#include <poco/list.h>
+#include <poco/platform.h>
+#include <poco/scheduler.h>
+#include <poco/scheduler_core.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct work_stealing_scheduler WorkStealingScheduler;
+
+typedef struct work_stealing_worker {
+    WorkStealingScheduler *scheduler;
+    pthread_t thread;
+    pthread_mutex_t lock; /**< Protects the ready list. */
+    ListNode ready_tasks;
+    Coro *current_task; /**< Task being run, accessed atomically. */
+    /** Set if an event matched the current task before it blocked, scheduler locked. */
+    bool wake_pending;
+    CoroEventSource pending_event; /**< Event that set wake_pending. */
+    /** Set if events were dropped while the current task ran, scheduler locked. */
+    bool wake_forced;
+} WorkStealingWorker;
+
+struct work_stealing_scheduler {
+    /** Task table, blocked tasks and external events, scheduler locked. */
+    SchedulerCore core;
+    WorkStealingWorker *workers;
+    size_t worker_count;
+    /** Worker given the next task readied outside of the workers, scheduler locked. */
+    size_t next_worker;
+    size_t idle_workers; /**< Workers waiting for work, accessed atomically. */
+    /** Protects the core, the task counts and idle_watched. */
+    pthread_mutex_t lock;
+    pthread_cond_t work_available; /**< Signalled when tasks become ready. */
+    bool idle_watched; /**< Set while an idle worker waits on the core's idle hook. */
+};
+
+/*!
+ * @brief Create a work-stealing scheduler.
+ *
+ * @param coro_list List of coroutines to schedule.
+ * @param num_coros Number of coroutines in the list.
+ * @param worker_count Number of worker threads, including the thread running the
+ *      scheduler.
+ *
+ * @return Pointer to the scheduler, or NULL on error.
+ */
+Scheduler *work_stealing_scheduler_create(Coro *const *coro_list, size_t num_coros,
+                                          size_t worker_count);
+
+/*!
+ * @brief Create a work-stealing scheduler from statically allocated storage.
+ *
+ * @param scheduler Scheduler to initialise.
+ * @param coro_list List of coroutines to schedule, owned by the scheduler once created.
+ * @param num_coros Number of coroutines in the list.
+ * @param workers Storage for the workers, owned by the scheduler once created.
+ * @param worker_count Number of workers, including the thread running the scheduler.
+ * @param event_slots Storage for external events, owned by the scheduler once created.
+ * @param event_slot_count Number of events from ISRs that can be held until a worker
+ *      handles them, must be a power of 2.
+ *
+ * @return Pointer to the scheduler, or NULL on error.
+ */
+Scheduler *work_stealing_scheduler_create_static(WorkStealingScheduler *scheduler,
+                                                 Coro **coro_list, size_t num_coros,
+                                                 WorkStealingWorker *workers,
+                                                 size_t worker_count,
+                                                 EventRingSlot *event_slots,
+                                                 size_t event_slot_count);
+
+/*!
+ * @brief Frees a dynamically allocated scheduler.
+ *
+ * @param scheduler Scheduler to free, must have been created from @ref
+ *      work_stealing_scheduler_create.
+ */
+void work_stealing_scheduler_free(WorkStealingScheduler *scheduler);
+
+#ifdef __cplusplus
+}
+#endif
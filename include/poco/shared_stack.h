@@ -0,0 +1,135 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Coroutines sharing one stack, copying their frames in and out.
+ *
+ * Each stackful coroutine normally owns a stack sized for its deepest call chain, even
+ * if it spends most of its life suspended in a shallow frame. A group of coroutines can
+ * instead run on one large shared stack. When another coroutine of the group is
+ * resumed, the frames of the suspended one are copied to a save buffer sized to what it
+ * actually uses, and copied back before it resumes.
+ *
+ * Memory per coroutine drops to its suspended stack depth, at the cost of a copy on
+ * every switch between coroutines of the same group.
+ *
+ * @warning Coroutines of a group must not hand out pointers to their locals to other
+ * coroutines of the same group, the frames move while the owner is suspended.
+ * @warning All coroutines of a group must be run by a single scheduler thread, they are
+ * not suited to the work-stealing scheduler.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <poco/coro.h>
+#include <poco/platform.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/** Bytes saved below the recorded stack pointer, for red zones and spilled state. */
+#define SHARED_STACK_SAVE_MARGIN (512)
+
+/*!
+ * @brief Stack shared by a group of coroutines.
+ */
+struct shared_stack {
+    PlatformStackElement *stack; /**< Stack memory. */
+    size_t stack_count;          /**< Number of elements in the stack. */
+    Coro *owner;                 /**< Coroutine whose frames are on the stack. */
+    bool platform_stack;         /**< Stack allocated with platform_stack_alloc(). */
+};
+
+/*!
+ * @brief Create a shared stack from statically allocated storage.
+ *
+ * @param shared Shared stack to initialise.
+ * @param stack Stack memory.
+ * @param stack_count Number of platform specific elements in the stack.
+ *
+ * @return Pointer to the shared stack, or NULL if the stack is too small.
+ */
+SharedStack *shared_stack_create_static(SharedStack *shared,
+                                        PlatformStackElement *stack,
+                                        size_t stack_count);
+
+/*!
+ * @brief Create a shared stack.
+ *
+ * @param stack_count Number of platform specific elements in the stack.
+ *
+ * @return Pointer to the shared stack, or NULL on error.
+ */
+SharedStack *shared_stack_create(size_t stack_count);
+
+/*!
+ * @brief Frees a dynamically created shared stack.
+ *
+ * @warning All coroutines created on the stack must have been freed.
+ *
+ * @param shared Shared stack to free.
+ */
+void shared_stack_free(SharedStack *shared);
+
+/*!
+ * @brief Create a coroutine on a shared stack, from statically allocated storage.
+ *
+ * The frames of the coroutine currently on the stack are saved first. A coroutine
+ * cannot create another coroutine on the stack it runs on.
+ *
+ * @note Freeing the coroutine with coro_destroy_static() releases its save buffer.
+ *
+ * @param coro Coroutine to initialise.
+ * @param entrypoint Entrypoint function.
+ * @param context User context passed into the entrypoint function.
+ * @param shared Stack to run the coroutine on.
+ *
+ * @return pointer to the coroutine, or NULL if a coroutine cannot be created, or if the
+ *      platform does not run coroutines on the provided stack (PLATFORM_OWN_STACKS).
+ */
+Coro *coro_create_shared_static(Coro *coro, CoroEntrypoint entrypoint, void *context,
+                                SharedStack *shared);
+
+/*!
+ * @brief Create a coroutine on a shared stack.
+ *
+ * @note Freeing the coroutine with coro_free() leaves the shared stack allocated.
+ *
+ * @param entrypoint Entrypoint function.
+ * @param context User context passed into the entrypoint function.
+ * @param shared Stack to run the coroutine on.
+ *
+ * @return pointer to the coroutine, or NULL if a coroutine cannot be created.
+ */
+Coro *coro_create_shared(CoroEntrypoint entrypoint, void *context,
+                         SharedStack *shared);
+
+/*!
+ * @brief Moves the frames of a coroutine onto its shared stack, ahead of resuming it.
+ *
+ * @warning Internal, called by coro_resume().
+ *
+ * @param shared Stack the coroutine runs on.
+ * @param coro Coroutine about to be resumed.
+ *
+ * @return true if the coroutine can be resumed, false if the frames of the current
+ * owner could not be saved.
+ */
+bool shared_stack_acquire(SharedStack *shared, Coro *coro);
+
+/*!
+ * @brief Releases the save buffer of a coroutine, and its claim on the shared stack.
+ *
+ * @warning Internal, called when a coroutine is destroyed.
+ *
+ * @param shared Stack the coroutine runs on.
+ * @param coro Coroutine being destroyed.
+ */
+void shared_stack_release(SharedStack *shared, Coro *coro);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,145 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Lock-free single-producer single-consumer queue, from another thread into a
+ * coroutine.
+ *
+ * A @ref queue relies on platform_enter_critical_section(), it is not safe to share
+ * with threads the scheduler does not run. This queue is fed by a single producer on
+ * any thread, such as a network reader, and drained by a single consumer coroutine.
+ *
+ * Putting an item is wait-free, it only uses acquire and release atomics, and a full
+ * fence to check if the consumer is waiting. The head, written by the producer, the
+ * tail, written by the consumer, and the wait flag are kept on separate cache lines.
+ * The blocked consumer is woken through scheduler_notify_from_isr(), the scheduler's
+ * external event path.
+ *
+ * @warning At most one producer and one consumer may use a queue at any time.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <poco/platform.h>
+#include <poco/result.h>
+#include <poco/scheduler.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef SPSC_QUEUE_CACHE_LINE_SIZE
+/** Size of a cache line, the head and the tail are kept this far apart. */
+#define SPSC_QUEUE_CACHE_LINE_SIZE (64)
+#endif
+
+typedef struct spsc_queue {
+    /* Written by the producer. */
+    size_t head;        /**< Next position to put into, accessed atomically. */
+    size_t cached_tail; /**< Tail last seen by the producer. */
+    uint8_t head_padding[SPSC_QUEUE_CACHE_LINE_SIZE - (2 * sizeof(size_t))];
+
+    /* Written by the consumer. */
+    size_t tail;        /**< Next position to get from, accessed atomically. */
+    size_t cached_head; /**< Head last seen by the consumer. */
+    uint8_t tail_padding[SPSC_QUEUE_CACHE_LINE_SIZE - (2 * sizeof(size_t))];
+
+    /* Written by the consumer when it blocks, read by the producer on every put. */
+    size_t waiting; /**< Non zero while the consumer is blocked, accessed atomically. */
+    /** Scheduler of the waiting consumer, accessed atomically. */
+    Scheduler *scheduler;
+    uint8_t *item_buffer;
+    size_t item_size;
+    size_t mask; /**< Item count - 1, the item count is a power of 2. */
+} SpscQueue;
+
+/*!
+ * @brief Initialises a statically defined queue.
+ *
+ * @param queue Queue to initialise.
+ * @param num_items Number of items this queue will manage, must be a power of 2.
+ * @param item_size Size of an individual item, in bytes.
+ * @param item_buffer Buffer containing enough space for the items.
+ *
+ * @return Pointer to the queue, or NULL if the number of items is not a power of 2.
+ */
+SpscQueue *spsc_queue_create_static(SpscQueue *queue, size_t num_items,
+                                    size_t item_size, uint8_t *item_buffer);
+
+/*!
+ * @brief Creates a queue with a fixed number of elements.
+ *
+ * @param num_items Number of items this queue will manage, must be a power of 2.
+ * @param item_size Size of an individual item, in bytes.
+ *
+ * @return Pointer to the queue, or NULL if an error has occurred.
+ */
+SpscQueue *spsc_queue_create(size_t num_items, size_t item_size);
+
+/*!
+ * @brief Frees a previously created queue.
+ *
+ * @warning Freeing a statically created queue is undefined.
+ *
+ * @param queue Queue to free.
+ */
+void spsc_queue_free(SpscQueue *queue);
+
+/*!
+ * @brief Gets the number of items in a queue.
+ *
+ * @note The count may be out of date as soon as it is returned, if the other side is
+ *      running.
+ *
+ * @param queue Queue to check.
+ *
+ * @return Number of items in the queue.
+ */
+size_t spsc_queue_item_count(SpscQueue const *queue);
+
+/*!
+ * @brief Puts an item into the queue, from the producer.
+ *
+ * Safe to call from any thread, or an ISR, but only from a single producer at a time.
+ * Never blocks, the producer decides how to handle a full queue.
+ *
+ * @param queue Queue to put the item into.
+ * @param item Item to put into the queue.
+ *
+ * @retval #RES_OK Item has been queued.
+ * @retval #RES_QUEUE_FULL Queue is full, no item has been inserted.
+ * @retval #RES_NOTIFY_FAILED if the operation failed to notify the scheduler.
+ */
+Result spsc_queue_put(SpscQueue *queue, void const *item);
+
+/*!
+ * @brief Gets an item from the queue, from the consumer coroutine.
+ *
+ * This operation blocks the calling coroutine until an item is available.
+ *
+ * @param queue Queue to get the item from.
+ * @param item Item to get from the queue.
+ * @param timeout Maximum time to wait before giving up.
+ *
+ * @retval #RES_OK on success.
+ * @retval #RES_TIMEOUT if the maximum time was awaited.
+ */
+Result spsc_queue_get(SpscQueue *queue, void *item, PlatformTick timeout);
+
+/*!
+ * @brief Gets an item without waiting, from the consumer.
+ *
+ * @param queue Queue to get the item from.
+ * @param item Item to get from the queue, only valid if result was #RES_OK.
+ *
+ * @retval #RES_OK An item has been taken.
+ * @retval #RES_QUEUE_EMPTY Queue has no items to get.
+ */
+Result spsc_queue_get_no_wait(SpscQueue *queue, void *item);
+
+#ifdef __cplusplus
+}
+#endif
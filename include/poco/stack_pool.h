@@ -0,0 +1,145 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Pool of recyclable coroutines and their stacks.
+ *
+ * Creating a coroutine allocates the coroutine and its stack. For applications spawning
+ * short-lived coroutines at runtime, a stack pool keeps finished coroutines on a free
+ * list instead of freeing them, and hands them out again without allocating.
+ *
+ * Stacks are grouped in a few fixed size classes. A coroutine gets a stack from the
+ * smallest class that fits the requested size. Each class can be pre-warmed, so that no
+ * allocation happens after startup.
+ *
+ * @warning Pools are not thread safe, use one pool per scheduler.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <poco/coro.h>
+#include <poco/result.h>
+#include <stddef.h>
+
+/** Maximum number of stack size classes in a pool. */
+#define STACK_POOL_MAX_CLASS_COUNT (8)
+
+typedef struct stack_pool_block StackPoolBlock;
+
+/*!
+ * @brief Coroutine and stack owned by a pool.
+ */
+struct stack_pool_block {
+    Coro coro;
+    StackPoolBlock *next; /**< Next free block of the same class. */
+};
+
+typedef struct stack_pool_class {
+    size_t stack_count;         /**< Stack size of the class, in stack elements. */
+    StackPoolBlock *free_block; /**< First block of the free list. */
+    size_t free_count;          /**< Number of blocks in the free list. */
+    size_t total_count;         /**< Number of blocks allocated for the class. */
+} StackPoolClass;
+
+typedef struct stack_pool {
+    StackPoolClass classes[STACK_POOL_MAX_CLASS_COUNT];
+    size_t class_count;
+} StackPool;
+
+/*!
+ * @brief Create a stack pool from statically allocated storage.
+ *
+ * No stacks are allocated until they are first used, or the pool is pre-warmed.
+ *
+ * @param pool Pool to initialise.
+ * @param stack_counts Stack size of each class, in stack elements, in ascending order.
+ * @param class_count Number of classes.
+ *
+ * @return Pointer to the pool, or NULL if the classes are invalid.
+ */
+StackPool *stack_pool_create_static(StackPool *pool, size_t const *stack_counts,
+                                    size_t class_count);
+
+/*!
+ * @brief Create a stack pool.
+ *
+ * @param stack_counts Stack size of each class, in stack elements, in ascending order.
+ * @param class_count Number of classes.
+ *
+ * @return Pointer to the pool, or NULL on error.
+ */
+StackPool *stack_pool_create(size_t const *stack_counts, size_t class_count);
+
+/*!
+ * @brief Frees the stacks of a pool.
+ *
+ * @warning All coroutines created from the pool must have been returned to it.
+ *
+ * @param pool Pool to release the stacks of.
+ */
+void stack_pool_destroy_static(StackPool *pool);
+
+/*!
+ * @brief Frees a dynamically created pool, and its stacks.
+ *
+ * @warning All coroutines created from the pool must have been returned to it.
+ *
+ * @param pool Pool to free.
+ */
+void stack_pool_free(StackPool *pool);
+
+/*!
+ * @brief Allocates stacks ahead of time.
+ *
+ * @param pool Pool to pre-warm.
+ * @param stack_count Stack size, in stack elements, selecting the class to pre-warm.
+ * @param block_count Number of free stacks the class should hold.
+ *
+ * @retval #RES_OK if the class holds at least block_count free stacks.
+ * @retval #RES_INVALID_VALUE if no class can hold stack_count elements.
+ * @retval #RES_NO_MEM if the stacks could not be allocated.
+ */
+Result stack_pool_prewarm(StackPool *pool, size_t stack_count, size_t block_count);
+
+/*!
+ * @brief Creates a coroutine with a stack from the pool.
+ *
+ * A free stack is reused if available, otherwise a new one is allocated.
+ *
+ * @param pool Pool to take the stack from.
+ * @param entrypoint Entrypoint function.
+ * @param context User context passed into the entrypoint function.
+ * @param stack_count Minimum number of stack elements.
+ *
+ * @return pointer to the coroutine, or NULL if a coroutine cannot be created.
+ */
+Coro *stack_pool_coro_create(StackPool *pool, CoroEntrypoint entrypoint, void *context,
+                             size_t stack_count);
+
+/*!
+ * @brief Returns a coroutine and its stack to the pool.
+ *
+ * @note The coroutine must have been removed from its scheduler.
+ *
+ * @param pool Pool the coroutine was created from.
+ * @param coro Coroutine to return, must be finished or not yet started.
+ */
+void stack_pool_coro_free(StackPool *pool, Coro *coro);
+
+/*!
+ * @brief Scheduler reaper returning finished coroutines to their pool.
+ *
+ * Matches #SchedulerReaper, pass the pool as the reaper context.
+ *
+ * @param coro Finished coroutine, created from the pool.
+ * @param pool Pool the coroutine was created from.
+ */
+void stack_pool_reap(Coro *coro, void *pool);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,195 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Stackless coroutines, scheduled next to stackful coroutines.
+ *
+ * A stackless coroutine has no stack of its own. Each time it is resumed, its step
+ * function is entered again from the top, and jumps to the label it last yielded from,
+ * in the style of protothreads. Local variables do not survive a yield, any state must
+ * be kept in the user context.
+ *
+ * Stackless coroutines block on the same event sinks as stackful coroutines, and are
+ * run by the same schedulers. Blocking primitive calls are not available to them, they
+ * use the `_no_wait` variants, along with CORO_STACKLESS_WAIT_UNTIL().
+ *
+ * @warning Only the `CORO_STACKLESS_*` macros may yield inside a step function.
+ * coro_yield(), coro_yield_to(), coro_yield_delay(), coro_join() and the blocking
+ * primitive calls switch stacks, they assert when called from a stackless coroutine.
+ *
+ * @code
+ * static CoroSignal consumer_step(Coro *coro, void *context) {
+ *     Consumer *consumer = context;
+ *
+ *     CORO_STACKLESS_BEGIN(coro);
+ *     while (true) {
+ *         CORO_STACKLESS_WAIT_UNTIL(
+ *             coro, queue_get_no_wait(consumer->queue, &consumer->item) == RES_OK,
+ *             CORO_EVTSINK_QUEUE_NOT_EMPTY, consumer->queue);
+ *         handle_item(consumer->item);
+ *     }
+ *     CORO_STACKLESS_END(coro);
+ * }
+ * @endcode
+ *
+ * A stackless coroutine is created without the execution state of stackful coroutines,
+ * such as their platform context, only the scheduling state is allocated.
+ *
+ * @note Labels are line numbers, only one yielding macro may be used per line.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <poco/coro.h>
+#include <poco/intracoro.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** Size of the scheduling state of a coroutine, all a stackless coroutine uses. */
+#define CORO_STACKLESS_SIZE (offsetof(Coro, entrypoint))
+
+/*!
+ * @brief Storage of a statically allocated stackless coroutine.
+ *
+ * Smaller than a #Coro, the execution state of stackful coroutines is left out. Only
+ * use it through the coroutine returned by coro_create_stackless_static().
+ */
+typedef union coro_stackless {
+    uint8_t storage[CORO_STACKLESS_SIZE]; /**< Scheduling state of the coroutine. */
+    long double align_float;              /**< Aligns the storage as a #Coro. */
+    int64_t align_int;                    /**< Aligns the storage as a #Coro. */
+    void *align_pointer;                  /**< Aligns the storage as a #Coro. */
+} CoroStackless;
+
+/*!
+ * @brief Starts the body of a step function.
+ *
+ * @param coro Coroutine passed to the step function.
+ */
+#define CORO_STACKLESS_BEGIN(coro)                                                     \
+    switch ((coro)->resume_label) {                                                    \
+    case 0:
+
+/*!
+ * @brief Ends the body of a step function, finishing the coroutine.
+ *
+ * @param coro Coroutine passed to the step function.
+ */
+#define CORO_STACKLESS_END(coro)                                                       \
+    }                                                                                  \
+    return coro_stackless_finish(coro)
+
+/*!
+ * @brief Yields to the scheduler, resuming from the next statement.
+ *
+ * @param coro Coroutine passed to the step function.
+ */
+#define CORO_STACKLESS_YIELD(coro)                                                     \
+    do {                                                                               \
+        (coro)->resume_label = __LINE__;                                               \
+        return coro_stackless_yield(coro);                                             \
+    case __LINE__:;                                                                    \
+    } while (0)
+
+/*!
+ * @brief Blocks for a time delay, resuming from the next statement.
+ *
+ * @param coro Coroutine passed to the step function.
+ * @param duration_ms Duration of the delay, in milliseconds.
+ */
+#define CORO_STACKLESS_DELAY(coro, duration_ms)                                        \
+    do {                                                                               \
+        (coro)->resume_label = __LINE__;                                               \
+        return coro_stackless_delay((coro), (duration_ms));                            \
+    case __LINE__:;                                                                    \
+    } while (0)
+
+/*!
+ * @brief Blocks until the condition holds, evaluating it each time the sink triggers.
+ *
+ * The condition is evaluated before blocking, and again after each wake-up, so it can
+ * perform a `_no_wait` primitive call.
+ *
+ * @param coro Coroutine passed to the step function.
+ * @param condition Expression to wait for.
+ * @param sink_type Event sink to block on while the condition does not hold.
+ * @param subject Subject of the event sink, e.g. a queue.
+ */
+#define CORO_STACKLESS_WAIT_UNTIL(coro, condition, sink_type, subject)                 \
+    while (!(condition)) {                                                             \
+        (coro)->resume_label = __LINE__;                                               \
+        return coro_stackless_wait((coro), (sink_type), (subject));                    \
+    case __LINE__:;                                                                    \
+    }
+
+/*!
+ * @brief Creates a statically defined stackless coroutine.
+ *
+ * @param storage Storage of the coroutine.
+ * @param step Step function.
+ * @param context User context passed into the step function.
+ *
+ * @return pointer to the coroutine, held in the storage, or NULL if parameters are
+ *      invalid.
+ */
+Coro *coro_create_stackless_static(CoroStackless *storage, CoroStep step,
+                                   void *context);
+
+/*!
+ * @brief Creates a stackless coroutine.
+ *
+ * Free it with coro_free().
+ *
+ * @param step Step function.
+ * @param context User context passed into the step function.
+ *
+ * @return pointer to the coroutine, or NULL if a coroutine cannot be created.
+ */
+Coro *coro_create_stackless(CoroStep step, void *context);
+
+/*!
+ * @brief Prepares a plain yield, used by CORO_STACKLESS_YIELD().
+ *
+ * @param coro Stackless coroutine.
+ *
+ * @return Signal to return from the step function.
+ */
+CoroSignal coro_stackless_yield(Coro *coro);
+
+/*!
+ * @brief Prepares the delay sink, used by CORO_STACKLESS_DELAY().
+ *
+ * @param coro Stackless coroutine.
+ * @param duration_ms Duration of the delay, in milliseconds.
+ *
+ * @return Signal to return from the step function.
+ */
+CoroSignal coro_stackless_delay(Coro *coro, int64_t duration_ms);
+
+/*!
+ * @brief Prepares the primary sink, used by CORO_STACKLESS_WAIT_UNTIL().
+ *
+ * @param coro Stackless coroutine.
+ * @param sink_type Event sink to block on.
+ * @param subject Subject of the event sink.
+ *
+ * @return Signal to return from the step function.
+ */
+CoroSignal coro_stackless_wait(Coro *coro, CoroEventSinkType sink_type, void *subject);
+
+/*!
+ * @brief Prepares the finished event, used by CORO_STACKLESS_END().
+ *
+ * @param coro Stackless coroutine.
+ *
+ * @return Signal to return from the step function.
+ */
+CoroSignal coro_stackless_finish(Coro *coro);
+
+#ifdef __cplusplus
+}
+#endif
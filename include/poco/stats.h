@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Optional runtime statistics of coroutines and schedulers.
+ *
+ * Statistics are only recorded when built with POCO_WITH_STATS. Otherwise the recording
+ * hooks compile to nothing, and coro_get_stats() and scheduler_get_stats() return
+ * #RES_NOT_SUPPORTED.
+ *
+ * Times are measured with platform_get_stats_ns(), in nanoseconds.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <poco/intracoro.h>
+#include <poco/platform.h>
+#include <stdint.h>
+
+/** Number of sink types blocked time is recorded for. */
+#define CORO_STATS_SINK_TYPE_COUNT (CORO_EVTSINK_STREAM_NOT_EMPTY + 1)
+
+/*!
+ * @brief Statistics of a coroutine.
+ */
+typedef struct coro_stats {
+    uint64_t resume_count; /**< Number of times the coroutine was resumed. */
+    int64_t running_ns;    /**< Time spent running, inside coro_resume(). */
+
+    /** Time spent ready, waiting to be resumed. The wait before the first resume is
+     * not counted, as it depends on when the scheduler is started. */
+    int64_t ready_ns;
+    int64_t max_ready_ns; /**< Longest wait from ready to running. */
+
+    /** Time spent blocked, by the type of sink blocked on. A timeout alone is counted
+     * as #CORO_EVTSINK_DELAY. */
+    int64_t blocked_ns[CORO_STATS_SINK_TYPE_COUNT];
+
+    int64_t state_changed_ns;       /**< Internal, time of the last state change. */
+    CoroEventSinkType blocked_sink; /**< Internal, type of the sink blocked on. */
+} CoroStats;
+
+/*!
+ * @brief Statistics of a scheduler.
+ */
+typedef struct scheduler_stats {
+    uint64_t pass_count;           /**< Number of scheduling passes. */
+    uint64_t event_overflow_count; /**< Times external events were dropped. */
+    int64_t idle_ns;               /**< Time spent idle, waiting for events. */
+} SchedulerStats;
+
+#ifdef POCO_WITH_STATS
+#define coro_stats_init(coro) ((coro)->stats = (CoroStats){0})
+#define scheduler_stats_init(scheduler) ((scheduler)->stats = (SchedulerStats){0})
+#define scheduler_stats_now() platform_get_stats_ns()
+#define scheduler_stats_add_pass(scheduler) ((scheduler)->stats.pass_count++)
+#define scheduler_stats_add_overflow(scheduler)                                        \
+    ((scheduler)->stats.event_overflow_count++)
+#define scheduler_stats_add_idle(scheduler, start)                                     \
+    ((scheduler)->stats.idle_ns += platform_get_stats_ns() - (start))
+#else
+#define coro_stats_init(coro)
+#define scheduler_stats_init(scheduler)
+#define scheduler_stats_now() (0)
+#define scheduler_stats_add_pass(scheduler)
+#define scheduler_stats_add_overflow(scheduler)
+#define scheduler_stats_add_idle(scheduler, start) ((void)(start))
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,122 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Intrusive min-heap of absolute deadlines.
+ *
+ * Used by schedulers to track coroutine timeouts. Only the timers that are due need to
+ * be visited when checking for expiry, making the cost of a scheduler pass independent
+ * of the number of waiting coroutines.
+ *
+ * The heap is a pairing heap, insertion is constant time, and removal of the earliest
+ * (or any) deadline is logarithmic (amortised).
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <poco/platform.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct timer_node TimerNode;
+
+/*!
+ * @brief Node within a timer heap, holding an absolute deadline.
+ */
+struct timer_node {
+    /** Tick value at which this timer expires. */
+    PlatformTick deadline;
+    /** First (leftmost) child. */
+    TimerNode *child;
+    /** Next sibling to the right. */
+    TimerNode *sibling;
+    /** Left sibling, or parent if leftmost. Points to itself for the root, and is NULL
+     * if the node is not in a heap. */
+    TimerNode *prev;
+};
+
+typedef struct timer_heap {
+    TimerNode *root;
+} TimerHeap;
+
+/*!
+ * @brief Initialises an empty timer heap.
+ *
+ * @param heap Heap to initialise.
+ */
+void timer_heap_init(TimerHeap *heap);
+
+/*!
+ * @brief Initialises a timer node as not belonging to any heap.
+ *
+ * @param node Node to initialise.
+ */
+void timer_node_init(TimerNode *node);
+
+/*!
+ * @brief Checks if the node is currently in a heap.
+ *
+ * @param node Node to check.
+ *
+ * @return True if the node is in a heap.
+ */
+static inline bool timer_node_is_linked(TimerNode const *node) {
+    return node->prev != NULL;
+}
+
+/*!
+ * @brief Checks if the heap has no timers.
+ *
+ * @param heap Heap to check.
+ *
+ * @return True if there are no timers in the heap.
+ */
+static inline bool timer_heap_is_empty(TimerHeap const *heap) {
+    return heap->root == NULL;
+}
+
+/*!
+ * @brief Gets the earliest timer in the heap, without removing it.
+ *
+ * @param heap Heap to check.
+ *
+ * @return The timer with the earliest deadline, or NULL if the heap is empty.
+ */
+static inline TimerNode *timer_heap_peek(TimerHeap const *heap) { return heap->root; }
+
+/*!
+ * @brief Adds a timer to the heap.
+ *
+ * @param heap Heap to add to.
+ * @param node Node to add, must not already be in a heap.
+ * @param deadline Absolute tick value the timer expires at.
+ */
+void timer_heap_insert(TimerHeap *heap, TimerNode *node, PlatformTick deadline);
+
+/*!
+ * @brief Removes a timer from the heap.
+ *
+ * @param heap Heap the node belongs to.
+ * @param node Node to remove, must be in the heap.
+ */
+void timer_heap_remove(TimerHeap *heap, TimerNode *node);
+
+/*!
+ * @brief Removes and returns the earliest timer, if it has expired.
+ *
+ * Call repeatedly to process all expired timers.
+ *
+ * @param heap Heap to check.
+ * @param now Current tick value.
+ *
+ * @return The expired timer, or NULL if no timer has expired.
+ */
+TimerNode *timer_heap_pop_expired(TimerHeap *heap, PlatformTick now);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,226 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Queues of a fixed item type and length, generated at compile time.
+ *
+ * A @ref queue stores its item size and length at runtime, every access multiplies,
+ * takes a modulo and copies a variable number of bytes. POCO_QUEUE_DEFINE() generates a
+ * queue for one item type and a power of 2 length instead. Indices are masked, and
+ * items are copied by assignment, which the compiler can inline.
+ *
+ * Typed queues block and notify on the same event sinks as @ref queue, they can be
+ * waited on alongside other primitives.
+ *
+ * @code
+ * POCO_QUEUE_DEFINE(message_queue, Message, 8)
+ *
+ * message_queue messages;
+ * message_queue_init(&messages);
+ * message_queue_put(&messages, &message, PLATFORM_TICKS_FOREVER);
+ * @endcode
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <poco/intracoro.h>
+#include <poco/platform.h>
+#include <poco/queue.h>
+#include <poco/result.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*!
+ * @brief Sets the sinks of the calling coroutine, before waiting on a typed queue.
+ *
+ * @warning Internal, called by the functions generated by POCO_QUEUE_DEFINE().
+ *
+ * @param queue Typed queue to wait on.
+ * @param sink_type #CORO_EVTSINK_QUEUE_NOT_FULL or #CORO_EVTSINK_QUEUE_NOT_EMPTY.
+ * @param timeout Maximum time to wait, over all the following waits.
+ */
+void typed_queue_prepare_wait(void *queue, CoroEventSinkType sink_type,
+                              PlatformTick timeout);
+
+/*!
+ * @brief Blocks the calling coroutine on the sinks set by typed_queue_prepare_wait().
+ *
+ * @warning Internal, called by the functions generated by POCO_QUEUE_DEFINE().
+ *
+ * @return False if the maximum time was awaited.
+ */
+bool typed_queue_wait(void);
+
+/*!
+ * @brief Notifies the scheduler of a put or get on a typed queue, yielding.
+ *
+ * @warning Internal, called by the functions generated by POCO_QUEUE_DEFINE().
+ *
+ * @param queue Typed queue put into or got from.
+ * @param source_type #CORO_EVTSRC_QUEUE_PUT or #CORO_EVTSRC_QUEUE_GET.
+ */
+void typed_queue_notify(void *queue, CoroEventSourceType source_type);
+
+/*!
+ * @brief Notifies the scheduler of a put or get on a typed queue, without yielding.
+ *
+ * @warning Internal, called by the functions generated by POCO_QUEUE_DEFINE().
+ *
+ * @param queue Typed queue put into or got from.
+ * @param source_type #CORO_EVTSRC_QUEUE_PUT or #CORO_EVTSRC_QUEUE_GET.
+ * @param from_isr True if called from an ISR.
+ *
+ * @retval #RES_OK on success.
+ * @retval #RES_NOTIFY_FAILED if the operation failed to notify the scheduler.
+ */
+Result typed_queue_notify_no_wait(void *queue, CoroEventSourceType source_type,
+                                  bool from_isr);
+
+/** Checks a queue length is a power of 2, at compile time. */
+#define TYPED_QUEUE_IS_POWER_OF_2(n) (((n) > 0) && (((n) & ((n)-1)) == 0))
+
+/*!
+ * @brief Defines a typed queue, and the functions operating on it.
+ *
+ * The queue type is named after the queue, and every function is prefixed with the
+ * queue name. Functions mirror their @ref queue counterparts.
+ *
+ * - `name_init(name *queue)` empties the queue, a zero initialised queue is also empty.
+ * - `name_put(name *queue, T const *item, PlatformTick timeout)`, and the
+ *   `name_put_no_wait` and `name_put_from_isr` variants without the timeout.
+ * - `name_get(name *queue, T *item, PlatformTick timeout)`, and the `name_get_no_wait`
+ *   and `name_get_from_isr` variants without the timeout.
+ * - `name_item_count`, `name_is_full` and `name_is_empty`.
+ *
+ * Functions are static inline, the macro can be used in a header shared by the
+ * producers and consumers.
+ *
+ * @param name Name of the queue type, and prefix of its functions.
+ * @param T Item type.
+ * @param N Maximum number of items, a power of 2.
+ */
+#define POCO_QUEUE_DEFINE(name, T, N)                                                  \
+    typedef char name##_length_is_a_power_of_2[TYPED_QUEUE_IS_POWER_OF_2(N) ? 1 : -1]; \
+                                                                                       \
+    typedef struct name {                                                              \
+        size_t volatile read_idx;  /* Free running, masked on access. */               \
+        size_t volatile write_idx; /* Free running, masked on access. */               \
+        T items[N];                                                                    \
+    } name;                                                                            \
+                                                                                       \
+    static inline void name##_init(name *queue) {                                      \
+        queue->read_idx = 0;                                                           \
+        queue->write_idx = 0;                                                          \
+    }                                                                                  \
+                                                                                       \
+    static inline size_t name##_item_count(name const *queue) {                        \
+        return queue->write_idx - queue->read_idx;                                     \
+    }                                                                                  \
+                                                                                       \
+    static inline bool name##_is_full(name const *queue) {                             \
+        return name##_item_count(queue) == (N);                                        \
+    }                                                                                  \
+                                                                                       \
+    static inline bool name##_is_empty(name const *queue) {                            \
+        return name##_item_count(queue) == 0;                                          \
+    }                                                                                  \
+                                                                                       \
+    /* Unsafe push, does not perform locking. */                                       \
+    static inline bool name##_push(name *queue, T const *item) {                       \
+        if (name##_is_full(queue)) {                                                   \
+            return false;                                                              \
+        }                                                                              \
+        queue->items[queue->write_idx & ((N)-1)] = *item;                              \
+        queue->write_idx++;                                                            \
+        return true;                                                                   \
+    }                                                                                  \
+                                                                                       \
+    /* Unsafe pop, does not perform locking. */                                        \
+    static inline bool name##_pop(name *queue, T *item) {                              \
+        if (name##_is_empty(queue)) {                                                  \
+            return false;                                                              \
+        }                                                                              \
+        *item = queue->items[queue->read_idx & ((N)-1)];                               \
+        queue->read_idx++;                                                             \
+        return true;                                                                   \
+    }                                                                                  \
+                                                                                       \
+    static inline bool name##_try_put(name *queue, T const *item) {                    \
+        platform_enter_critical_section();                                             \
+        bool const put_success = name##_push(queue, item);                             \
+        platform_exit_critical_section();                                              \
+        return put_success;                                                            \
+    }                                                                                  \
+                                                                                       \
+    static inline bool name##_try_get(name *queue, T *item) {                          \
+        platform_enter_critical_section();                                             \
+        bool const get_success = name##_pop(queue, item);                              \
+        platform_exit_critical_section();                                              \
+        return get_success;                                                            \
+    }                                                                                  \
+                                                                                       \
+    static inline Result name##_put(name *queue, T const *item,                        \
+                                    PlatformTick const timeout) {                      \
+        if (!name##_try_put(queue, item)) {                                            \
+            /* Sinks are set once, so wake-ups do not restart the timeout. */          \
+            typed_queue_prepare_wait(queue, CORO_EVTSINK_QUEUE_NOT_FULL, timeout);     \
+            do {                                                                       \
+                if (!typed_queue_wait()) {                                             \
+                    return RES_TIMEOUT;                                                \
+                }                                                                      \
+            } while (!name##_try_put(queue, item));                                    \
+        }                                                                              \
+        typed_queue_notify(queue, CORO_EVTSRC_QUEUE_PUT);                              \
+        return RES_OK;                                                                 \
+    }                                                                                  \
+                                                                                       \
+    static inline Result name##_put_no_wait(name *queue, T const *item) {              \
+        if (!name##_try_put(queue, item)) {                                            \
+            return RES_QUEUE_FULL;                                                     \
+        }                                                                              \
+        return typed_queue_notify_no_wait(queue, CORO_EVTSRC_QUEUE_PUT, false);        \
+    }                                                                                  \
+                                                                                       \
+    static inline Result name##_put_from_isr(name *queue, T const *item) {             \
+        if (!name##_push(queue, item)) {                                               \
+            return RES_QUEUE_FULL;                                                     \
+        }                                                                              \
+        return typed_queue_notify_no_wait(queue, CORO_EVTSRC_QUEUE_PUT, true);         \
+    }                                                                                  \
+                                                                                       \
+    static inline Result name##_get(name *queue, T *item,                              \
+                                    PlatformTick const timeout) {                      \
+        if (!name##_try_get(queue, item)) {                                            \
+            /* Sinks are set once, so wake-ups do not restart the timeout. */          \
+            typed_queue_prepare_wait(queue, CORO_EVTSINK_QUEUE_NOT_EMPTY, timeout);    \
+            do {                                                                       \
+                if (!typed_queue_wait()) {                                             \
+                    return RES_TIMEOUT;                                                \
+                }                                                                      \
+            } while (!name##_try_get(queue, item));                                    \
+        }                                                                              \
+        typed_queue_notify(queue, CORO_EVTSRC_QUEUE_GET);                              \
+        return RES_OK;                                                                 \
+    }                                                                                  \
+                                                                                       \
+    static inline Result name##_get_no_wait(name *queue, T *item) {                    \
+        if (!name##_try_get(queue, item)) {                                            \
+            return RES_QUEUE_EMPTY;                                                    \
+        }                                                                              \
+        return typed_queue_notify_no_wait(queue, CORO_EVTSRC_QUEUE_GET, false);        \
+    }                                                                                  \
+                                                                                       \
+    static inline Result name##_get_from_isr(name *queue, T *item) {                   \
+        if (!name##_pop(queue, item)) {                                                \
+            return RES_QUEUE_EMPTY;                                                    \
+        }                                                                              \
+        return typed_queue_notify_no_wait(queue, CORO_EVTSRC_QUEUE_GET, true);         \
+    }
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Per-subject wait lists for blocked coroutines.
+ *
+ * Used by schedulers to route an event only to the coroutines blocked on the event's
+ * subject, instead of broadcasting each event to every coroutine.
+ *
+ * Coroutines are tracked by the subject in their primary event sink. Subjects are
+ * hashed into a fixed number of buckets, each bucket being a list of waiting
+ * coroutines.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <poco/coro.h>
+#include <poco/intracoro.h>
+#include <poco/list.h>
+#include <stddef.h>
+
+#ifndef WAIT_TABLE_BUCKET_COUNT
+/** Number of subject buckets in a wait table, must be a power of 2. */
+#define WAIT_TABLE_BUCKET_COUNT (32)
+#endif
+
+typedef struct wait_table {
+    ListNode buckets[WAIT_TABLE_BUCKET_COUNT];
+} WaitTable;
+
+/*!
+ * @brief Initialises a wait table with no waiting coroutines.
+ *
+ * @param table Wait table to initialise.
+ */
+void wait_table_init(WaitTable *table);
+
+/*!
+ * @brief Adds a blocked coroutine to the wait list of its primary sink's subject.
+ *
+ * Coroutines with no subject in their primary sink (i.e. only waiting on a delay) are
+ * not added.
+ *
+ * @param table Wait table to add to.
+ * @param coro Blocked coroutine.
+ */
+void wait_table_add(WaitTable *table, Coro *coro);
+
+/*!
+ * @brief Removes a coroutine from any wait list it is part of.
+ *
+ * Safe to call on coroutines that are not waiting.
+ *
+ * @param coro Coroutine to remove.
+ */
+void wait_table_remove(Coro *coro);
+
+/*!
+ * @brief Notifies the coroutines waiting on the event's subject.
+ *
+ * Coroutines unblocked by the event are moved from their wait list to the end of the
+ * unblocked list, in the order they started waiting.
+ *
+ * @note Events without a subject (no-op and elapsed events) are ignored.
+ *
+ * @param table Wait table to notify.
+ * @param event Event to notify.
+ * @param unblocked List receiving the unblocked coroutines.
+ *
+ * @return Number of coroutines unblocked by the event.
+ */
+size_t wait_table_notify(WaitTable *table, CoroEventSource const *event,
+                         ListNode *unblocked);
+
+/*!
+ * @brief Unblocks all the coroutines in the table, whatever they are waiting on.
+ *
+ * Used when events may have been lost, the unblocked coroutines re-check their
+ * condition and block again if it is not met.
+ *
+ * @param table Wait table to empty.
+ * @param unblocked List receiving the unblocked coroutines.
+ *
+ * @return Number of coroutines unblocked.
+ */
+size_t wait_table_notify_all(WaitTable *table, ListNode *unblocked);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,269 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Unix platform implementation.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poco/platform.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifdef POCO_WITH_THREADS
+#include <pthread.h>
+#endif
+
+#ifdef POCO_WITH_ASM_CONTEXT
+#include <string.h>
+#endif
+
+/** Upper bound of a single sleep when no wake-up pipe is available. */
+#define IDLE_FALLBACK_POLL_MS (1)
+
+#ifdef POCO_WITH_THREADS
+static pthread_once_t critical_section_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t critical_section_lock;
+
+static void init_critical_section(void) {
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    /* Primitives nest critical sections, e.g. queue_raw_put() within notify(). */
+    pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&critical_section_lock, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+}
+
+void platform_lock(void) {
+    pthread_once(&critical_section_once, init_critical_section);
+    pthread_mutex_lock(&critical_section_lock);
+}
+
+void platform_unlock(void) { pthread_mutex_unlock(&critical_section_lock); }
+#endif
+
+#ifdef POCO_WITH_ASM_CONTEXT
+/** Assembly trampoline calling the entrypoint saved in the initial frame. */
+extern void platform_context_entry(void);
+
+#if defined(__x86_64__)
+/** Default SSE control word, all exceptions masked, round to nearest. */
+#define DEFAULT_MXCSR (0x1F80u)
+/** Default x87 control word, all exceptions masked, extended precision. */
+#define DEFAULT_FPU_CONTROL_WORD (0x037Fu)
+
+/** Initial frame, matching the layout popped by platform_context_switch. */
+typedef struct initial_frame {
+    uint32_t mxcsr;
+    uint16_t fpu_control_word;
+    uint16_t padding;
+    void *r15;
+    void *r14; /**< User context. */
+    void *r13; /**< Coroutine. */
+    void *r12; /**< Entrypoint. */
+    void *rbx;
+    void *rbp;
+    void *return_address;
+    /** Keeps the stack 16 byte aligned once the frame is popped. */
+    void *alignment[2];
+} InitialFrame;
+#elif defined(__aarch64__)
+/** Initial frame, matching the layout popped by platform_context_switch. */
+typedef struct initial_frame {
+    void *x19; /**< Entrypoint. */
+    void *x20; /**< Coroutine. */
+    void *x21; /**< User context. */
+    void *x22_x28[7];
+    void *x29;
+    void *x30; /**< Return address. */
+    uint64_t d8_d15[8];
+    uint64_t fpcr;
+    uint64_t padding;
+} InitialFrame;
+#else
+#error "POCO_WITH_ASM_CONTEXT is not supported on this architecture"
+#endif
+
+void platform_make_context(PlatformContext *context, void (*entrypoint)(void *, void *),
+                           void *coro, void *user_context) {
+    uintptr_t stack_top =
+        (uintptr_t)context->uc_stack.ss_sp + context->uc_stack.ss_size;
+    /* Both ABIs require a 16 byte aligned stack. */
+    stack_top &= ~(uintptr_t)15;
+
+    InitialFrame *frame = (InitialFrame *)(stack_top - sizeof(InitialFrame));
+    memset(frame, 0, sizeof(InitialFrame));
+
+#if defined(__x86_64__)
+    frame->mxcsr = DEFAULT_MXCSR;
+    frame->fpu_control_word = DEFAULT_FPU_CONTROL_WORD;
+    frame->r12 = (void *)entrypoint;
+    frame->r13 = coro;
+    frame->r14 = user_context;
+    frame->return_address = (void *)platform_context_entry;
+#elif defined(__aarch64__)
+    frame->x19 = (void *)entrypoint;
+    frame->x20 = coro;
+    frame->x21 = user_context;
+    frame->x30 = (void *)platform_context_entry;
+#endif
+
+    context->stack_pointer = frame;
+}
+
+int platform_set_context(PlatformContext *context) {
+    void *discarded_stack_pointer = NULL;
+    platform_context_switch(&discarded_stack_pointer, context->stack_pointer);
+    /* Does not return. */
+    return -1;
+}
+#endif
+
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE (0)
+#endif
+
+#ifndef MAP_STACK
+#define MAP_STACK (0)
+#endif
+
+/*!
+ * @brief Gets the size of a mapped stack, excluding its guard page.
+ *
+ * @return The page rounded size, or 0 if the stack should be allocated from the heap.
+ */
+static size_t get_mapped_size(size_t const stack_count, size_t const page_size) {
+    size_t const size = stack_count * sizeof(PlatformStackElement);
+
+    if (size < PLATFORM_STACK_MAP_THRESHOLD) {
+        return 0;
+    }
+
+    return (size + page_size - 1) & ~(page_size - 1);
+}
+
+PlatformStackElement *platform_stack_alloc(size_t const stack_count) {
+    size_t const page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size_t const size = get_mapped_size(stack_count, page_size);
+
+    if (size == 0) {
+        return calloc(stack_count, sizeof(PlatformStackElement));
+    }
+
+    /* Anonymous mappings are zero filled, and committed page by page on first touch. */
+    int const flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK;
+    uint8_t *base = mmap(NULL, page_size + size, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+
+    /* Stacks grow down, the guard page sits below the lowest element. */
+    if (mprotect(base, page_size, PROT_NONE) != 0) {
+        munmap(base, page_size + size);
+        return NULL;
+    }
+
+    return (PlatformStackElement *)(base + page_size);
+}
+
+void platform_stack_free(PlatformStackElement *stack, size_t const stack_count) {
+    size_t const page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size_t const size = get_mapped_size(stack_count, page_size);
+
+    if ((stack == NULL) || (size == 0)) {
+        free(stack);
+        return;
+    }
+
+    munmap((uint8_t *)stack - page_size, page_size + size);
+}
+
+static int set_pipe_flags(int fd) {
+    int const status_flags = fcntl(fd, F_GETFL);
+    int const fd_flags = fcntl(fd, F_GETFD);
+
+    if ((status_flags < 0) || (fd_flags < 0)) {
+        return -1;
+    }
+
+    if ((fcntl(fd, F_SETFL, status_flags | O_NONBLOCK) < 0) ||
+        (fcntl(fd, F_SETFD, fd_flags | FD_CLOEXEC) < 0)) {
+        return -1;
+    }
+
+    return 0;
+}
+
+void platform_idle_init(PlatformIdle *idle) {
+    int fds[2];
+
+    idle->read_fd = -1;
+    idle->write_fd = -1;
+
+    if (pipe(fds) != 0) {
+        /* Fall back to short sleeps, see platform_idle_wait(). */
+        return;
+    }
+
+    if ((set_pipe_flags(fds[0]) != 0) || (set_pipe_flags(fds[1]) != 0)) {
+        close(fds[0]);
+        close(fds[1]);
+        return;
+    }
+
+    idle->read_fd = fds[0];
+    idle->write_fd = fds[1];
+}
+
+void platform_idle_wait(PlatformIdle *idle, PlatformTick const ticks) {
+    /* Ticks are milliseconds on this platform. */
+    int timeout_ms = -1;
+    if (ticks != PLATFORM_TICKS_FOREVER) {
+        timeout_ms = (ticks > INT_MAX) ? INT_MAX : (int)((ticks > 0) ? ticks : 0);
+    }
+
+    if (idle->read_fd < 0) {
+        /* Nothing can wake us up, only sleep for a short time. */
+        if ((timeout_ms < 0) || (timeout_ms > IDLE_FALLBACK_POLL_MS)) {
+            timeout_ms = IDLE_FALLBACK_POLL_MS;
+        }
+        poll(NULL, 0, timeout_ms);
+        return;
+    }
+
+    struct pollfd waiter = {.fd = idle->read_fd, .events = POLLIN, .revents = 0};
+
+    if (poll(&waiter, 1, timeout_ms) > 0) {
+        /* Drain all pending wake-ups, they are all handled by the next pass. */
+        char buffer[16];
+        while (read(idle->read_fd, buffer, sizeof(buffer)) > 0) {
+        }
+    }
+}
+
+void platform_idle_wake(PlatformIdle *idle) {
+    if (idle->write_fd < 0) {
+        return;
+    }
+
+    int const saved_errno = errno;
+    char const token = 0;
+    /* A full pipe already has a wake-up pending, the write can be dropped. */
+    (void)write(idle->write_fd, &token, 1);
+    errno = saved_errno;
+}
+
+void platform_idle_destroy(PlatformIdle *idle) {
+    if (idle->read_fd >= 0) {
+        close(idle->read_fd);
+    }
+    if (idle->write_fd >= 0) {
+        close(idle->write_fd);
+    }
+    idle->read_fd = -1;
+    idle->write_fd = -1;
+}
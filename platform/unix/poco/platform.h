@@ -29,6 +29,59 @@ typedef uint32_t PlatformStackElement;
 /** Minimum stack size needed to run the coroutine, in platform specific elements. */
 #define MIN_STACK_SIZE (MINSIGSTKSZ / sizeof(PlatformStackElement))
 
+#ifdef POCO_WITH_ASM_CONTEXT
+
+typedef struct stack_descriptor {
+    void *ss_sp;    /**< Lowest address of the stack. */
+    size_t ss_size; /**< Stack size, in bytes. */
+} StackDescriptor;
+
+typedef struct platform_context PlatformContext;
+
+/*!
+ * @brief Minimal context, only the callee-saved registers are preserved.
+ *
+ * Registers are pushed on the suspended stack, the context only holds the stack
+ * pointer. The ucontext field names are kept for compatibility.
+ */
+struct platform_context {
+    PlatformContext *uc_link; /**< Unused, finished coroutines never return. */
+    StackDescriptor uc_stack;
+    void *stack_pointer; /**< Saved stack pointer of a suspended context. */
+};
+
+/*!
+ * @brief Saves the callee-saved registers to the current stack, then switches stack.
+ *
+ * Implemented in assembly for each supported architecture.
+ *
+ * @param old_stack_pointer Receives the stack pointer of the current context.
+ * @param new_stack_pointer Stack pointer of the context to resume.
+ */
+void platform_context_switch(void **old_stack_pointer, void *new_stack_pointer);
+
+/*!
+ * @brief Builds the initial stack frame of a context, entering entrypoint once resumed.
+ */
+void platform_make_context(PlatformContext *context, void (*entrypoint)(void *, void *),
+                           void *coro, void *user_context);
+
+int platform_set_context(PlatformContext *context);
+
+static inline int platform_get_context(PlatformContext *context) {
+    /* All state is saved when switching, there is nothing to capture beforehand. */
+    (void)context;
+    return 0;
+}
+
+static inline int platform_swap_context(PlatformContext *old_context,
+                                        PlatformContext const *new_context) {
+    platform_context_switch(&old_context->stack_pointer, new_context->stack_pointer);
+    return 0;
+}
+
+#else
+
 typedef ucontext_t PlatformContext;
 
 #define platform_get_context(context) getcontext(context)
@@ -41,8 +94,44 @@ typedef ucontext_t PlatformContext;
 #define platform_make_context(context, entrypoint, coro, user_context)                 \
     makecontext(context, (void (*)(void))entrypoint, 2, coro, user_context)
 
+#endif
+
 #define platform_destroy_context(context) // no context to destroy
 
+// Platform Stacks
+
+/** Stacks of at least this many bytes are mapped, smaller ones are allocated. */
+#ifndef PLATFORM_STACK_MAP_THRESHOLD
+#define PLATFORM_STACK_MAP_THRESHOLD (16 * 1024)
+#endif
+
+/**
+ * Stacks from platform_stack_alloc() are zero filled, and only committed when touched.
+ * They must not be painted.
+ */
+#define PLATFORM_STACK_LAZY_COMMIT
+
+/*!
+ * @brief Allocates a coroutine stack.
+ *
+ * Large stacks are mapped with no swap reservation, so pages are only committed once
+ * touched, above a guard page faulting on overflow. Smaller stacks are allocated from
+ * the heap, as a guard page would outweigh them.
+ *
+ * @param stack_count Number of stack elements.
+ *
+ * @return Pointer to the zero filled stack, or NULL if out of memory.
+ */
+PlatformStackElement *platform_stack_alloc(size_t stack_count);
+
+/*!
+ * @brief Frees a stack allocated with platform_stack_alloc().
+ *
+ * @param stack Stack to free, may be NULL.
+ * @param stack_count Number of stack elements the stack was allocated with.
+ */
+void platform_stack_free(PlatformStackElement *stack, size_t stack_count);
+
 // Platform Timing
 typedef int64_t PlatformTick;
 
@@ -56,8 +145,71 @@ static inline PlatformTick platform_get_monotonic_ticks(void) {
 
 #define platform_get_ticks_per_ms() (1)
 
+/*!
+ * @brief Gets a fine grained monotonic time, in nanoseconds, used for statistics.
+ */
+static inline int64_t platform_get_stats_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + (int64_t)ts.tv_nsec;
+}
+
+#ifdef POCO_WITH_THREADS
+/*!
+ * @brief Enters the process wide critical section, may be nested.
+ */
+void platform_lock(void);
+
+/*!
+ * @brief Exits the process wide critical section.
+ */
+void platform_unlock(void);
+
+#define platform_enter_critical_section() platform_lock()
+#define platform_exit_critical_section() platform_unlock()
+#else
 #define platform_enter_critical_section()
 #define platform_exit_critical_section()
+#endif
+
+// Platform Idle
+
+/** Self-pipe used to wake an idle scheduler, writes are async-signal-safe. */
+typedef struct platform_idle {
+    int read_fd;  /**< Polled while idle, -1 if the pipe could not be created. */
+    int write_fd; /**< Written to on wake-up, -1 if the pipe could not be created. */
+} PlatformIdle;
+
+/*!
+ * @brief Initialises the idle object of a scheduler.
+ *
+ * @param idle Idle object to initialise.
+ */
+void platform_idle_init(PlatformIdle *idle);
+
+/*!
+ * @brief Blocks the calling thread until woken, or until the timeout elapses.
+ *
+ * @param idle Idle object to wait on.
+ * @param ticks Maximum ticks to wait for, or PLATFORM_TICKS_FOREVER.
+ */
+void platform_idle_wait(PlatformIdle *idle, PlatformTick ticks);
+
+/*!
+ * @brief Wakes a thread waiting in platform_idle_wait(), or the next one to wait.
+ *
+ * Safe to call from a signal handler or from another thread.
+ *
+ * @param idle Idle object to wake.
+ */
+void platform_idle_wake(PlatformIdle *idle);
+
+/*!
+ * @brief Releases the resources held by an idle object.
+ *
+ * @param idle Idle object to destroy.
+ */
+void platform_idle_destroy(PlatformIdle *idle);
 
 #ifdef __cplusplus
 }
@@ -66,3 +66,37 @@ int platform_destroy_context(PlatformContext *context) {
     }
     return 0;
 }
+
+void platform_idle_init(PlatformIdle *idle) {
+    idle->event = CreateEvent(NULL, FALSE, FALSE, NULL);
+}
+
+void platform_idle_wait(PlatformIdle *idle, PlatformTick const ticks) {
+    /* Ticks are milliseconds on this platform. */
+    DWORD timeout_ms = INFINITE;
+    if (ticks != PLATFORM_TICKS_FOREVER) {
+        timeout_ms = (ticks >= INFINITE) ? (INFINITE - 1)
+                                         : (DWORD)((ticks > 0) ? ticks : 0);
+    }
+
+    if (idle->event == NULL) {
+        /* Nothing can wake us up, only sleep for a short time. */
+        Sleep((timeout_ms > 1) ? 1 : timeout_ms);
+        return;
+    }
+
+    WaitForSingleObject(idle->event, timeout_ms);
+}
+
+void platform_idle_wake(PlatformIdle *idle) {
+    if (idle->event != NULL) {
+        SetEvent(idle->event);
+    }
+}
+
+void platform_idle_destroy(PlatformIdle *idle) {
+    if (idle->event != NULL) {
+        CloseHandle(idle->event);
+        idle->event = NULL;
+    }
+}
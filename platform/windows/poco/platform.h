@@ -15,6 +15,7 @@ extern "C" {
 
 #include <stddef.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <time.h>
 #include <windows.h>
 
@@ -28,6 +29,11 @@ typedef uint32_t PlatformStackElement;
 /** Minimum stack size needed to run the coroutine, in platform specific elements. */
 #define MIN_STACK_SIZE (3) /* In windows, stack is always dynamic */
 
+/**
+ * Coroutines run on fiber stacks owned by Windows, never on the stack they are given.
+ */
+#define PLATFORM_OWN_STACKS
+
 typedef struct stack_descriptor {
     /**< Pointer to a stack, note that stack must be double word aligned. */
     void *ss_sp;
@@ -56,6 +62,12 @@ int platform_make_context(PlatformContext *context, void (*entrypoint)(void *, v
 
 int platform_destroy_context(PlatformContext *context);
 
+// Platform Stacks
+#define platform_stack_alloc(stack_count)                                              \
+    ((PlatformStackElement *)malloc((stack_count) * sizeof(PlatformStackElement)))
+
+#define platform_stack_free(stack, stack_count) free(stack)
+
 // Platform Timing
 typedef int64_t PlatformTick;
 
@@ -72,9 +84,36 @@ static inline PlatformTick platform_get_monotonic_ticks(void) {
 
 #define platform_get_ticks_per_ms() (1)
 
+/*!
+ * @brief Gets a fine grained monotonic time, in nanoseconds, used for statistics.
+ */
+static inline int64_t platform_get_stats_ns(void) {
+    LARGE_INTEGER freq, counter;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&counter);
+    // Split the conversion, so that the counter cannot overflow.
+    return (counter.QuadPart / freq.QuadPart) * 1000000000 +
+           ((counter.QuadPart % freq.QuadPart) * 1000000000) / freq.QuadPart;
+}
+
 #define platform_enter_critical_section()
 #define platform_exit_critical_section()
 
+// Platform Idle
+
+/** Auto-reset event used to wake an idle scheduler. */
+typedef struct platform_idle {
+    HANDLE event; /**< NULL if the event could not be created. */
+} PlatformIdle;
+
+void platform_idle_init(PlatformIdle *idle);
+
+void platform_idle_wait(PlatformIdle *idle, PlatformTick ticks);
+
+void platform_idle_wake(PlatformIdle *idle);
+
+void platform_idle_destroy(PlatformIdle *idle);
+
 #ifdef __cplusplus
 }
 #endif
@@ -15,6 +15,7 @@ extern "C" {
 
 #include <stddef.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <zephyr/irq.h>
 #include <zephyr/kernel.h>
 
@@ -91,6 +92,12 @@ void platform_make_context(PlatformContext *context, void (*entrypoint)(void *,
 
 #define platform_destroy_context(context) // no context to destroy
 
+// Platform Stacks
+#define platform_stack_alloc(stack_count)                                              \
+    ((PlatformStackElement *)malloc((stack_count) * sizeof(PlatformStackElement)))
+
+#define platform_stack_free(stack, stack_count) free(stack)
+
 typedef int64_t PlatformTick;
 
 #define PLATFORM_TICKS_FOREVER (INT64_MIN)
@@ -104,9 +111,35 @@ static inline PlatformTick platform_get_monotonic_ticks(void) {
 //        milliseconds, we will have a small drift over time with this.
 #define platform_get_ticks_per_ms() (CONFIG_SYS_CLOCK_TICKS_PER_SEC / 1000)
 
+/*!
+ * @brief Gets a monotonic time, in nanoseconds, used for statistics.
+ *
+ * Only as fine grained as the system tick.
+ */
+static inline int64_t platform_get_stats_ns(void) {
+    return (int64_t)k_ticks_to_ns_floor64(k_uptime_ticks());
+}
+
 #define platform_enter_critical_section() int key = irq_lock()
 #define platform_exit_critical_section() irq_unlock(key)
 
+// Platform Idle
+
+/** Binary semaphore used to wake an idle scheduler, can be given from an ISR. */
+typedef struct platform_idle {
+    struct k_sem wake;
+} PlatformIdle;
+
+#define platform_idle_init(idle) k_sem_init(&(idle)->wake, 0, 1)
+
+#define platform_idle_wait(idle, ticks)                                                \
+    k_sem_take(&(idle)->wake,                                                          \
+               ((ticks) == PLATFORM_TICKS_FOREVER) ? K_FOREVER : K_TICKS(ticks))
+
+#define platform_idle_wake(idle) k_sem_give(&(idle)->wake)
+
+#define platform_idle_destroy(idle) // no idle resources to destroy
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Priority scheduler example.
+ *
+ * A producer hands items to a higher priority consumer, while a low priority task
+ * performs bulk work.
+ *
+ * Each time the producer yields, the consumer runs first as it has a higher priority,
+ * and the bulk work only runs once both the producer and consumer are done.
+ */
+
+#include <poco/poco.h>
+#include <stdio.h>
+
+#define CONSUMER_STOP (-1)
+
+#define STACK_SIZE (DEFAULT_STACK_SIZE)
+
+#define QUEUE_COUNT (10)
+
+#define PRIORITY_BULK (0)
+#define PRIORITY_PRODUCER (1)
+#define PRIORITY_CONSUMER (2)
+
+void producer_task(void *context) {
+    Queue *queue = context;
+    for (int i = 0; i < 3; ++i) {
+        queue_put(queue, &i, PLATFORM_TICKS_FOREVER);
+        printf("Put %d\n", i);
+        coro_yield();
+    }
+    int const sentinel = CONSUMER_STOP;
+    queue_put(queue, &sentinel, PLATFORM_TICKS_FOREVER);
+    printf("Put %d\n", sentinel);
+}
+
+void consumer_task(void *context) {
+    Queue *queue = context;
+    while (1) {
+        int received_value = 0;
+        queue_get(queue, &received_value, PLATFORM_TICKS_FOREVER);
+        printf("Got: %d\n", received_value);
+
+        if (received_value == CONSUMER_STOP) {
+            printf("Done\n");
+            break;
+        }
+    }
+}
+
+void bulk_task(void *context) {
+    (void)context;
+    for (int i = 0; i < 3; ++i) {
+        printf("Bulk work %d\n", i);
+        coro_yield();
+    }
+}
+
+int main(void) {
+
+    Queue *queue_handle = queue_create(QUEUE_COUNT, sizeof(int));
+
+    Coro *bulk_handle = coro_create(bulk_task, NULL, STACK_SIZE);
+    Coro *producer_handle = coro_create(producer_task, queue_handle, STACK_SIZE);
+    Coro *consumer_handle = coro_create(consumer_task, queue_handle, STACK_SIZE);
+
+    if ((bulk_handle == NULL) || (producer_handle == NULL) ||
+        (consumer_handle == NULL)) {
+        /* Memory error */
+        return -1;
+    }
+
+    Coro *tasks[] = {bulk_handle, producer_handle, consumer_handle};
+    uint8_t const priorities[] = {PRIORITY_BULK, PRIORITY_PRODUCER, PRIORITY_CONSUMER};
+
+    Scheduler *scheduler =
+        priority_scheduler_create(tasks, priorities, sizeof(tasks) / sizeof(tasks[0]));
+
+    if (scheduler == NULL) {
+        printf("Failed to create scheduler\n");
+        return -1;
+    }
+
+    scheduler_run(scheduler);
+
+    /* Everything finished, no need to free as the process will terminate. */
+
+    return 0;
+}
@@ -0,0 +1,153 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Atomic operations shared by the lock-free primitives.
+ *
+ * GCC and Clang provide the `__atomic` builtins. MSVC only provides interlocked
+ * operations, plain loads and stores are ordered per target: x86 and x64 only reorder
+ * stores after later loads, so holding back the compiler is enough for acquire and
+ * release, while ARM and ARM64 need a data memory barrier.
+ *
+ * @warning Internal, only included by the library sources.
+ */
+
+#pragma once
+
+#include <poco/platform.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+
+#if defined(_M_ARM64)
+#define ATOMIC_OPS_BARRIER() __dmb(_ARM64_BARRIER_ISH)
+#define ATOMIC_OPS_LOAD(value) ((size_t)__iso_volatile_load64((__int64 const *)(value)))
+#define ATOMIC_OPS_STORE(value, new_value)                                             \
+    __iso_volatile_store64((__int64 *)(value), (__int64)(new_value))
+#elif defined(_M_ARM)
+#define ATOMIC_OPS_BARRIER() __dmb(_ARM_BARRIER_ISH)
+#define ATOMIC_OPS_LOAD(value) ((size_t)__iso_volatile_load32((int const *)(value)))
+#define ATOMIC_OPS_STORE(value, new_value)                                             \
+    __iso_volatile_store32((int *)(value), (int)(new_value))
+#elif defined(_M_IX86) || defined(_M_X64)
+#define ATOMIC_OPS_BARRIER() _ReadWriteBarrier()
+#define ATOMIC_OPS_LOAD(value) (*(size_t const volatile *)(value))
+#define ATOMIC_OPS_STORE(value, new_value) (*(size_t volatile *)(value) = (new_value))
+#else
+#error "Atomic operations are not implemented for this MSVC target"
+#endif
+
+static inline size_t atomic_ops_load_acquire(size_t const *value) {
+    size_t const result = ATOMIC_OPS_LOAD(value);
+    ATOMIC_OPS_BARRIER();
+    return result;
+}
+
+static inline void atomic_ops_store_release(size_t *value, size_t const new_value) {
+    ATOMIC_OPS_BARRIER();
+    ATOMIC_OPS_STORE(value, new_value);
+}
+
+static inline void atomic_ops_fence_acquire(void) { ATOMIC_OPS_BARRIER(); }
+
+static inline void atomic_ops_fence_full(void) {
+#if defined(_M_IX86) || defined(_M_X64)
+    /* Interlocked operations are full barriers. */
+    long volatile barrier = 0;
+    _InterlockedOr(&barrier, 0);
+#else
+    ATOMIC_OPS_BARRIER();
+#endif
+}
+
+static inline bool atomic_ops_compare_exchange(size_t *value, size_t const expected,
+                                               size_t const desired) {
+#ifdef _WIN64
+    return (size_t)_InterlockedCompareExchange64((__int64 volatile *)value,
+                                                 (__int64)desired,
+                                                 (__int64)expected) == expected;
+#else
+    return (size_t)_InterlockedCompareExchange((long volatile *)value, (long)desired,
+                                               (long)expected) == expected;
+#endif
+}
+
+static inline size_t atomic_ops_exchange(size_t *value, size_t const new_value) {
+#ifdef _WIN64
+    return (size_t)_InterlockedExchange64((__int64 volatile *)value,
+                                          (__int64)new_value);
+#else
+    return (size_t)_InterlockedExchange((long volatile *)value, (long)new_value);
+#endif
+}
+
+static inline void atomic_ops_increment(size_t *value) {
+#ifdef _WIN64
+    _InterlockedIncrement64((__int64 volatile *)value);
+#else
+    _InterlockedIncrement((long volatile *)value);
+#endif
+}
+
+static inline void atomic_ops_add_ticks(PlatformTick *value, PlatformTick const ticks) {
+    _InterlockedExchangeAdd64((__int64 volatile *)value, ticks);
+}
+
+static inline PlatformTick atomic_ops_exchange_ticks(PlatformTick *value,
+                                                     PlatformTick const ticks) {
+    return _InterlockedExchange64((__int64 volatile *)value, ticks);
+}
+
+static inline PlatformTick atomic_ops_load_ticks(PlatformTick const *value) {
+    /* A plain 64 bit load may tear on 32 bit targets, compare with itself instead. */
+    return _InterlockedCompareExchange64((__int64 volatile *)value, 0, 0);
+}
+
+#else
+
+static inline size_t atomic_ops_load_acquire(size_t const *value) {
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+
+static inline void atomic_ops_store_release(size_t *value, size_t const new_value) {
+    __atomic_store_n(value, new_value, __ATOMIC_RELEASE);
+}
+
+static inline void atomic_ops_fence_acquire(void) {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+}
+
+static inline void atomic_ops_fence_full(void) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline bool atomic_ops_compare_exchange(size_t *value, size_t expected,
+                                               size_t const desired) {
+    return __atomic_compare_exchange_n(value, &expected, desired, false,
+                                       __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+}
+
+static inline size_t atomic_ops_exchange(size_t *value, size_t const new_value) {
+    return __atomic_exchange_n(value, new_value, __ATOMIC_SEQ_CST);
+}
+
+static inline void atomic_ops_increment(size_t *value) {
+    __atomic_fetch_add(value, 1, __ATOMIC_RELAXED);
+}
+
+static inline void atomic_ops_add_ticks(PlatformTick *value, PlatformTick const ticks) {
+    __atomic_fetch_add(value, ticks, __ATOMIC_RELAXED);
+}
+
+static inline PlatformTick atomic_ops_exchange_ticks(PlatformTick *value,
+                                                     PlatformTick const ticks) {
+    return __atomic_exchange_n(value, ticks, __ATOMIC_RELAXED);
+}
+
+static inline PlatformTick atomic_ops_load_ticks(PlatformTick const *value) {
+    return __atomic_load_n(value, __ATOMIC_RELAXED);
+}
+
+#endif
@@ -5,9 +5,11 @@
  * @brief Base coroutine implementation.
  */
 
+#include <assert.h>
 #include <poco/context.h>
 #include <poco/coro.h>
 #include <poco/coro_raw.h>
+#include <poco/shared_stack.h>
 #include <string.h>
 
 // These are reversed so they appear cute when debugging.
@@ -15,6 +17,13 @@
 #define STACK_END_MAGIC (0xEFBEADBA)   // 0xBAADBEEF
 #define STACK_PAINT_MAGIC (0x55)
 
+#ifdef PLATFORM_STACK_LAZY_COMMIT
+/* Painting would commit every page of the stack. */
+#define PAINT_PLATFORM_STACKS (false)
+#else
+#define PAINT_PLATFORM_STACKS (true)
+#endif
+
 static void enter_coro(Coro *coro, void *context) {
     coro->entrypoint(context);
 
@@ -24,94 +33,155 @@ static void enter_coro(Coro *coro, void *context) {
     coro_yield_with_signal(CORO_SIG_NOTIFY_AND_DONE);
 }
 
-static bool update_event_sink(CoroEventSink *sink, CoroEventSource const *event) {
-    bool unblock_task = false;
+#ifdef POCO_WITH_STATS
+/*!
+ * @brief Accounts the time a coroutine spent blocked, now that it is ready.
+ */
+static void record_unblocked(Coro *coro) {
+    CoroStats *stats = &coro->stats;
+    int64_t const now = platform_get_stats_ns();
+    stats->blocked_ns[stats->blocked_sink] += now - stats->state_changed_ns;
+    stats->state_changed_ns = now;
+}
 
-    switch (event->type) {
-    case CORO_EVTSRC_ELAPSED:
-        if (sink->type == CORO_EVTSINK_DELAY &&
-            sink->params.ticks_remaining != PLATFORM_TICKS_FOREVER) {
-            /* We need to consider both signed and unsigned cases. */
-            if (event->params.elapsed_ticks > sink->params.ticks_remaining) {
-                sink->params.ticks_remaining = 0;
-            } else {
-                sink->params.ticks_remaining -= event->params.elapsed_ticks;
-            }
-            sink->params.ticks_remaining -= event->params.elapsed_ticks;
-            unblock_task = (sink->params.ticks_remaining <= 0);
+/*!
+ * @brief Accounts the time a coroutine waited to be resumed.
+ */
+static void record_resumed(Coro *coro) {
+    CoroStats *stats = &coro->stats;
+    int64_t const now = platform_get_stats_ns();
+    if (stats->resume_count > 0) {
+        int64_t const ready_ns = now - stats->state_changed_ns;
+        stats->ready_ns += ready_ns;
+        if (ready_ns > stats->max_ready_ns) {
+            stats->max_ready_ns = ready_ns;
         }
-        break;
+    }
+    stats->resume_count++;
+    stats->state_changed_ns = now;
+}
+
+/*!
+ * @brief Accounts the time a coroutine ran, and what it blocks on.
+ */
+static void record_suspended(Coro *coro) {
+    CoroStats *stats = &coro->stats;
+    int64_t const now = platform_get_stats_ns();
+    stats->running_ns += now - stats->state_changed_ns;
+    stats->state_changed_ns = now;
+
+    if (coro->coro_state == CORO_STATE_BLOCKED) {
+        CoroEventSink const *sinks = coro->event_sinks;
+        stats->blocked_sink = (sinks[EVENT_SINK_SLOT_PRIMARY].type != CORO_EVTSINK_NONE)
+                                  ? sinks[EVENT_SINK_SLOT_PRIMARY].type
+                                  : sinks[EVENT_SINK_SLOT_TIMEOUT].type;
+    }
+}
+#else
+#define record_unblocked(coro)
+#define record_resumed(coro)
+#define record_suspended(coro)
+#endif
+
+/*!
+ * @brief Switches back to the scheduler, recording how deep the stack is in use.
+ */
+static void suspend_coro(Coro *coro) {
+    /* Stackless coroutines only yield by returning from their step function, they are
+     * allocated without the contexts switched through here. */
+    assert(coro->step == NULL);
+    if (coro->step != NULL) {
+        return;
+    }
+
+    uint8_t stack_marker = 0;
+    coro->stack_pointer = &stack_marker;
+    platform_swap_context(&coro->resume_context, coro->suspend_context);
+}
+
+static bool sink_matches_subject_event(CoroEventSink const *sink,
+                                       CoroEventSource const *event) {
+    bool matches = false;
+
+    switch (event->type) {
     case CORO_EVTSRC_QUEUE_GET:
-        if (sink->type == CORO_EVTSINK_QUEUE_NOT_FULL) {
-            unblock_task = (sink->params.subject == event->params.subject);
-        }
+        matches = (sink->type == CORO_EVTSINK_QUEUE_NOT_FULL);
         break;
     case CORO_EVTSRC_QUEUE_PUT:
-        if (sink->type == CORO_EVTSINK_QUEUE_NOT_EMPTY) {
-            unblock_task = (sink->params.subject == event->params.subject);
-        }
+        matches = (sink->type == CORO_EVTSINK_QUEUE_NOT_EMPTY);
         break;
     case CORO_EVTSRC_EVENT_SET:
-        if (sink->type == CORO_EVTSINK_EVENT_GET) {
-            unblock_task = (sink->params.subject == event->params.subject);
-        }
+        matches = (sink->type == CORO_EVTSINK_EVENT_GET);
         break;
     case CORO_EVTSRC_SEMAPHORE_RELEASE:
-        if (sink->type == CORO_EVTSINK_SEMAPHORE_ACQUIRE) {
-            unblock_task = (sink->params.subject == event->params.subject);
-        }
+        matches = (sink->type == CORO_EVTSINK_SEMAPHORE_ACQUIRE);
         break;
     case CORO_EVTSRC_MUTEX_RELEASE:
-        if (sink->type == CORO_EVTSINK_MUTEX_ACQUIRE) {
-            unblock_task = (sink->params.subject == event->params.subject);
-        }
+        matches = (sink->type == CORO_EVTSINK_MUTEX_ACQUIRE);
         break;
     case CORO_EVTSRC_CORO_FINISHED:
-        if (sink->type == CORO_EVTSINK_WAIT_FINISH) {
-            unblock_task = (sink->params.subject == event->params.subject);
-        }
+        matches = (sink->type == CORO_EVTSINK_WAIT_FINISH);
         break;
     case CORO_EVTSRC_STREAM_RECV:
-        if (sink->type == CORO_EVTSINK_STREAM_NOT_FULL) {
-            unblock_task = (sink->params.subject == event->params.subject);
-        }
+        matches = (sink->type == CORO_EVTSINK_STREAM_NOT_FULL);
         break;
     case CORO_EVTSRC_STREAM_SEND:
-        if (sink->type == CORO_EVTSINK_STREAM_NOT_EMPTY) {
-            unblock_task = (sink->params.subject == event->params.subject);
-        }
+        matches = (sink->type == CORO_EVTSINK_STREAM_NOT_EMPTY);
         break;
     default:
-        unblock_task = false;
+        matches = false;
     }
-    return unblock_task;
+
+    return matches && (sink->params.subject == event->params.subject);
 }
 
-Coro *coro_create_static(Coro *coro, CoroEntrypoint const entrypoint, void *context,
-                         PlatformStackElement *stack, size_t const stack_count) {
+static bool update_event_sink(CoroEventSink *sink, CoroEventSource const *event) {
+    bool unblock_task = false;
 
-    if (stack_count < 3) {
-        /* need at least 3 elements: start magic, usable stack, end magic */
-        return NULL;
+    if (event->type == CORO_EVTSRC_ELAPSED) {
+        if (sink->type == CORO_EVTSINK_DELAY &&
+            sink->params.ticks_remaining != PLATFORM_TICKS_FOREVER) {
+            /* We need to consider both signed and unsigned cases. */
+            if (event->params.elapsed_ticks > sink->params.ticks_remaining) {
+                sink->params.ticks_remaining = 0;
+            } else {
+                sink->params.ticks_remaining -= event->params.elapsed_ticks;
+            }
+            unblock_task = (sink->params.ticks_remaining <= 0);
+        }
+    } else {
+        unblock_task = sink_matches_subject_event(sink, event);
     }
 
-    // paint the stack with 0x55s
-    // mark the start of the stack with a magic number,
-    // and the end with another magic number, we will reduce the stack size by 2 bytes
-    memset(stack, STACK_PAINT_MAGIC, stack_count);
-    stack[0] = STACK_START_MAGIC;
-    stack[stack_count - 1] = STACK_END_MAGIC;
+    return unblock_task;
+}
 
+/*!
+ * @brief Prepares a coroutine to run its entrypoint from the start of its stack.
+ */
+static Coro *init_coro(Coro *coro, CoroEntrypoint const entrypoint, void *context) {
     coro->coro_state = CORO_STATE_READY;
     coro->entrypoint = entrypoint;
-    coro->stack = stack;
-    coro->stack_size = stack_count;
-    coro->resume_context.uc_stack.ss_sp = (void *)(stack + 1);
+    coro->step = NULL;
+    coro->step_context = NULL;
+    coro->resume_label = 0;
+    list_node_init(&coro->list_node);
+    timer_node_init(&coro->timer_node);
+    coro->priority = 0;
+    coro->task_index = 0;
+    coro->yield_target = NULL;
+    coro_stats_init(coro);
+    coro->shared_stack = NULL;
+    /* Nothing in use yet, besides the initial frame at the top. */
+    coro->stack_pointer = (void *)(coro->stack + coro->stack_size - 1);
+    coro->saved_stack = NULL;
+    coro->saved_stack_size = 0;
+    coro->resume_context.uc_stack.ss_sp = (void *)(coro->stack + 1);
     coro->resume_context.uc_stack.ss_size =
-        (stack_count - 2) * sizeof(PlatformStackElement);
+        (coro->stack_size - 2) * sizeof(PlatformStackElement);
     coro->resume_context.uc_link = 0;
 
-    memset(&coro->suspend_context, 0, sizeof(coro->suspend_context));
+    coro->suspend_context = NULL;
 
     platform_get_context(&coro->resume_context);
     platform_make_context(&coro->resume_context, (void (*)(void *, void *))enter_coro,
@@ -119,6 +189,67 @@ Coro *coro_create_static(Coro *coro, CoroEntrypoint const entrypoint, void *cont
     return coro;
 }
 
+/*!
+ * @brief Creates a coroutine on the provided stack, optionally painting it.
+ */
+static Coro *create_on_stack(Coro *coro, CoroEntrypoint const entrypoint, void *context,
+                             PlatformStackElement *stack, size_t const stack_count,
+                             bool const paint) {
+    if (stack_count < 3) {
+        /* need at least 3 elements: start magic, usable stack, end magic */
+        return NULL;
+    }
+
+    if (paint) {
+        // paint the stack with 0x55s
+        // mark the start of the stack with a magic number,
+        // and the end with another magic number, we will reduce the stack size by 2
+        memset(stack, STACK_PAINT_MAGIC, stack_count * sizeof(PlatformStackElement));
+        stack[0] = STACK_START_MAGIC;
+    }
+    stack[stack_count - 1] = STACK_END_MAGIC;
+
+    coro->stack = stack;
+    coro->stack_size = stack_count;
+
+    return init_coro(coro, entrypoint, context);
+}
+
+Coro *coro_create_static(Coro *coro, CoroEntrypoint const entrypoint, void *context,
+                         PlatformStackElement *stack, size_t const stack_count) {
+    return create_on_stack(coro, entrypoint, context, stack, stack_count, true);
+}
+
+Coro *coro_create_platform_stack(Coro *coro, CoroEntrypoint const entrypoint,
+                                 void *context, PlatformStackElement *stack,
+                                 size_t const stack_count) {
+    return create_on_stack(coro, entrypoint, context, stack, stack_count,
+                           PAINT_PLATFORM_STACKS);
+}
+
+Coro *coro_reset(Coro *coro, CoroEntrypoint const entrypoint, void *context) {
+    if ((coro->coro_state != CORO_STATE_READY) &&
+        (coro->coro_state != CORO_STATE_FINISHED)) {
+        /* The stack is still in use. */
+        return NULL;
+    }
+
+    if ((coro->step != NULL) || (coro->shared_stack != NULL)) {
+        /* Stackless, or the stack may hold the frames of other coroutines. */
+        return NULL;
+    }
+
+    coro_destroy_static(coro);
+
+    /*
+     * The stack keeps its paint and start marker, an overwritten start marker still
+     * reports the overflow. Only the end marker needs restoring.
+     */
+    coro->stack[coro->stack_size - 1] = STACK_END_MAGIC;
+
+    return init_coro(coro, entrypoint, context);
+}
+
 Coro *coro_create(CoroEntrypoint const entrypoint, void *context,
                   size_t const stack_count) {
     Coro *coro = malloc(sizeof(Coro));
@@ -128,7 +259,7 @@ Coro *coro_create(CoroEntrypoint const entrypoint, void *context,
     }
 
     // we can only create items which are multiples of PlatformStackElement.
-    PlatformStackElement *stack = malloc(sizeof(PlatformStackElement) * stack_count);
+    PlatformStackElement *stack = platform_stack_alloc(stack_count);
 
     if (stack == NULL) {
         /* No memory. */
@@ -136,18 +267,27 @@ Coro *coro_create(CoroEntrypoint const entrypoint, void *context,
         return NULL;
     }
 
-    Coro *coro_handle = coro_create_static(coro, entrypoint, context, stack, stack_count);
+    Coro *coro_handle =
+        coro_create_platform_stack(coro, entrypoint, context, stack, stack_count);
     if (coro_handle == NULL) {
         free(coro);
-        free(stack);
+        platform_stack_free(stack, stack_count);
     }
 
     return coro_handle;
 }
 
 void coro_destroy_static(Coro *coro) {
+    if (coro->step != NULL) {
+        /* Stackless, there is no execution state to release. */
+        return;
+    }
+
+    if (coro->shared_stack != NULL) {
+        shared_stack_release(coro->shared_stack, coro);
+        coro->shared_stack = NULL;
+    }
     platform_destroy_context(&coro->resume_context);
-    platform_destroy_context(&coro->suspend_context);
 }
 
 void coro_free(Coro *coro) {
@@ -156,18 +296,62 @@ void coro_free(Coro *coro) {
         return;
     }
 
-    free(coro->stack);
+    if ((coro->step == NULL) && (coro->shared_stack == NULL)) {
+        platform_stack_free(coro->stack, coro->stack_size);
+    }
 
     coro_destroy_static(coro);
 
     free(coro);
 }
 
+size_t coro_stack_high_water(Coro const *coro) {
+#ifdef PLATFORM_OWN_STACKS
+    /* The coroutine runs on a stack owned by the platform, the given one is unused. */
+    (void)coro;
+    return 0;
+#else
+    if (coro->step != NULL) {
+        /* Stackless coroutines run on the scheduler's stack. */
+        return 0;
+    }
+
+    PlatformStackElement const *stack = coro->stack;
+
+    size_t const usable_count = coro->stack_size - 2;
+    PlatformStackElement paint = 0;
+
+    if (stack[0] == STACK_START_MAGIC) {
+        memset(&paint, STACK_PAINT_MAGIC, sizeof(paint));
+    } else if (stack[0] != 0) {
+        /* The start marker was overwritten, the stack overflowed. */
+        return usable_count;
+    }
+    /* Otherwise the stack was not painted, untouched elements are still zero. */
+
+    /* Stacks grow down, the first element in use bounds the peak use. */
+    size_t idx = 1;
+    while ((idx <= usable_count) && (stack[idx] == paint)) {
+        ++idx;
+    }
+
+    return usable_count + 1 - idx;
+#endif
+}
+
 void coro_yield(void) {
     Coro *coro = context_get_coro();
     coro->event_source.type = CORO_EVTSRC_NOOP;
     coro->yield_signal = CORO_SIG_NOTIFY;
-    platform_swap_context(&coro->resume_context, &coro->suspend_context);
+    suspend_coro(coro);
+}
+
+void coro_yield_to(Coro *target) {
+    Coro *coro = context_get_coro();
+    coro->yield_target = target;
+    coro->event_source.type = CORO_EVTSRC_NOOP;
+    coro->yield_signal = CORO_SIG_NOTIFY;
+    suspend_coro(coro);
 }
 
 void coro_yield_delay(int64_t const duration_ms) {
@@ -178,20 +362,20 @@ void coro_yield_delay(int64_t const duration_ms) {
         duration_ms * platform_get_ticks_per_ms();
 
     coro->yield_signal = CORO_SIG_WAIT;
-    platform_swap_context(&coro->resume_context, &coro->suspend_context);
+    suspend_coro(coro);
 }
 
 void coro_yield_with_event(CoroEventSource const *event) {
     Coro *coro = context_get_coro();
     coro->event_source = *event;
     coro->yield_signal = CORO_SIG_NOTIFY;
-    platform_swap_context(&coro->resume_context, &coro->suspend_context);
+    suspend_coro(coro);
 }
 
 void coro_yield_with_signal(CoroSignal const signal) {
     Coro *coro = context_get_coro();
     coro->yield_signal = signal;
-    platform_swap_context(&coro->resume_context, &coro->suspend_context);
+    suspend_coro(coro);
 }
 
 bool coro_notify(Coro *coro, CoroEventSource const *event) {
@@ -207,6 +391,7 @@ bool coro_notify(Coro *coro, CoroEventSource const *event) {
         if (unblock_task) {
             coro->triggered_event_sink_slot = idx;
             coro->coro_state = CORO_STATE_READY;
+            record_unblocked(coro);
             break;
         }
     }
@@ -214,12 +399,71 @@ bool coro_notify(Coro *coro, CoroEventSource const *event) {
     return unblock_task;
 }
 
+bool coro_event_matches(Coro const *coro, CoroEventSource const *event) {
+    for (size_t idx = 0; (idx < EVENT_SINK_SLOT_COUNT); ++idx) {
+        if (sink_matches_subject_event(&coro->event_sinks[idx], event)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool coro_wake(Coro *coro) {
+    if (coro->coro_state != CORO_STATE_BLOCKED) {
+        return false;
+    }
+
+    coro->triggered_event_sink_slot = EVENT_SINK_SLOT_PRIMARY;
+    coro->coro_state = CORO_STATE_READY;
+    record_unblocked(coro);
+    return true;
+}
+
+bool coro_notify_timeout(Coro *coro) {
+    if (coro->coro_state != CORO_STATE_BLOCKED) {
+        /* Only blocked coroutines can time out. */
+        return false;
+    }
+
+    for (size_t idx = 0; (idx < EVENT_SINK_SLOT_COUNT); ++idx) {
+        if (coro->event_sinks[idx].type == CORO_EVTSINK_DELAY) {
+            coro->event_sinks[idx].params.ticks_remaining = 0;
+            coro->triggered_event_sink_slot = idx;
+            coro->coro_state = CORO_STATE_READY;
+            record_unblocked(coro);
+            return true;
+        }
+    }
+
+    return false;
+}
+
 CoroSignal coro_resume(Coro *coro) {
     if (coro->coro_state == CORO_STATE_FINISHED)
         return CORO_SIG_NOTIFY_AND_DONE;
 
+    if ((coro->step == NULL) && (coro->shared_stack != NULL) &&
+        !shared_stack_acquire(coro->shared_stack, coro)) {
+        /* The frames on the shared stack could not be saved, retry on a later pass. */
+        coro->event_source.type = CORO_EVTSRC_NOOP;
+        coro->yield_signal = CORO_SIG_NOTIFY;
+        return coro->yield_signal;
+    }
+
+    record_resumed(coro);
+    coro->yield_target = NULL;
     coro->coro_state = CORO_STATE_RUNNING;
-    platform_swap_context(&coro->suspend_context, &coro->resume_context);
+    if (coro->step != NULL) {
+        /* Stackless, the step function returns at its next yield. */
+        coro->yield_signal = coro->step(coro, coro->step_context);
+    } else {
+        /* A scheduler runs one coroutine at a time, the coroutine switches back to the
+         * context saved here once it yields. */
+        PlatformContext suspend_context;
+        coro->suspend_context = &suspend_context;
+        platform_swap_context(&suspend_context, &coro->resume_context);
+        coro->suspend_context = NULL;
+    }
 
     switch (coro->yield_signal) {
     case CORO_SIG_NOTIFY:
@@ -233,6 +477,7 @@ CoroSignal coro_resume(Coro *coro) {
         coro->coro_state = CORO_STATE_BLOCKED;
         break;
     }
+    record_suspended(coro);
 
     return coro->yield_signal;
 }
@@ -249,5 +494,19 @@ void coro_join(Coro *coro) {
     this_coro->event_sinks[EVENT_SINK_SLOT_PRIMARY].params.subject = coro;
     this_coro->event_sinks[EVENT_SINK_SLOT_TIMEOUT].type = CORO_EVTSINK_NONE;
 
-    coro_yield_with_signal(CORO_SIG_WAIT);
+    /* Schedulers may wake us spuriously, only return once the coroutine is done. */
+    while (coro->coro_state != CORO_STATE_FINISHED) {
+        coro_yield_with_signal(CORO_SIG_WAIT);
+    }
+}
+
+Result coro_get_stats(Coro const *coro, CoroStats *stats) {
+#ifdef POCO_WITH_STATS
+    *stats = coro->stats;
+    return RES_OK;
+#else
+    (void)coro;
+    (void)stats;
+    return RES_NOT_SUPPORTED;
+#endif
 }
@@ -0,0 +1,145 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Lock-free multi-producer single-consumer event ring implementation.
+ *
+ * Bounded ring with per-slot sequence numbers. A slot at position P is free for
+ * producers when its sequence is P, and published for the consumer when it is P + 1.
+ *
+ * Producers look for duplicates in the published slots without claiming them. A slot
+ * is read between two loads of its sequence number, and only trusted if the sequence
+ * number did not change, as the consumer may free it and another producer reuse it
+ * meanwhile.
+ */
+
+#include "atomic_ops.h"
+#include <poco/event_ring.h>
+#include <stdint.h>
+
+/*!
+ * @brief Checks if an event with the same type and subject is waiting to be read.
+ */
+static bool _is_pending(EventRing *ring, CoroEventSource const *event) {
+    size_t const head = atomic_ops_load_acquire(&ring->head);
+    size_t position = atomic_ops_load_acquire(&ring->tail);
+
+    /* The tail may have passed the sampled head, the distance is then negative. */
+    while ((intptr_t)(head - position) > 0) {
+        EventRingSlot const *slot = &ring->slots[position & ring->mask];
+        size_t const sequence = atomic_ops_load_acquire(&slot->sequence);
+        CoroEventSource const pending = slot->event;
+        atomic_ops_fence_acquire();
+
+        if ((sequence == (position + 1)) &&
+            (atomic_ops_load_acquire(&slot->sequence) == sequence) &&
+            (pending.type == event->type) &&
+            (pending.params.subject == event->params.subject)) {
+            return true;
+        }
+
+        position++;
+    }
+
+    return false;
+}
+
+EventRing *event_ring_create_static(EventRing *ring, EventRingSlot *slots,
+                                    size_t const slot_count) {
+    if ((slot_count == 0) || ((slot_count & (slot_count - 1)) != 0)) {
+        return NULL;
+    }
+
+    for (size_t idx = 0; idx < slot_count; ++idx) {
+        slots[idx].sequence = idx;
+    }
+
+    ring->slots = slots;
+    ring->mask = slot_count - 1;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->elapsed_ticks = 0;
+    ring->overflow_count = 0;
+    ring->checked_overflow_count = 0;
+
+    return ring;
+}
+
+Result event_ring_put(EventRing *ring, CoroEventSource const *event) {
+    if (event->type == CORO_EVTSRC_ELAPSED) {
+        atomic_ops_add_ticks(&ring->elapsed_ticks, event->params.elapsed_ticks);
+        return RES_OK;
+    }
+
+    if (_is_pending(ring, event)) {
+        /* The waiting event wakes the same coroutines. */
+        return RES_OK;
+    }
+
+    size_t position = atomic_ops_load_acquire(&ring->head);
+    EventRingSlot *slot = NULL;
+
+    for (;;) {
+        slot = &ring->slots[position & ring->mask];
+        intptr_t const distance =
+            (intptr_t)atomic_ops_load_acquire(&slot->sequence) - (intptr_t)position;
+
+        if (distance == 0) {
+            if (atomic_ops_compare_exchange(&ring->head, position, position + 1)) {
+                break;
+            }
+        } else if (distance < 0) {
+            /* The slot still holds an event from the previous lap. */
+            atomic_ops_increment(&ring->overflow_count);
+            return RES_QUEUE_FULL;
+        }
+
+        /* Another producer claimed the slot, retry with the latest head. */
+        position = atomic_ops_load_acquire(&ring->head);
+    }
+
+    slot->event = *event;
+    atomic_ops_store_release(&slot->sequence, position + 1);
+
+    return RES_OK;
+}
+
+Result event_ring_get(EventRing *ring, CoroEventSource *event) {
+    if (atomic_ops_load_ticks(&ring->elapsed_ticks) != 0) {
+        event->type = CORO_EVTSRC_ELAPSED;
+        event->params.elapsed_ticks =
+            atomic_ops_exchange_ticks(&ring->elapsed_ticks, 0);
+        return RES_OK;
+    }
+
+    EventRingSlot *slot = &ring->slots[ring->tail & ring->mask];
+
+    if (atomic_ops_load_acquire(&slot->sequence) != (ring->tail + 1)) {
+        /* Not yet published. */
+        return RES_QUEUE_EMPTY;
+    }
+
+    *event = slot->event;
+    /* Free the slot for the producers of the next lap. */
+    atomic_ops_store_release(&slot->sequence, ring->tail + ring->mask + 1);
+    atomic_ops_store_release(&ring->tail, ring->tail + 1);
+
+    return RES_OK;
+}
+
+bool event_ring_is_empty(EventRing const *ring) {
+    EventRingSlot const *slot = &ring->slots[ring->tail & ring->mask];
+    return (atomic_ops_load_ticks(&ring->elapsed_ticks) == 0) &&
+           (atomic_ops_load_acquire(&slot->sequence) != (ring->tail + 1));
+}
+
+size_t event_ring_overflow_count(EventRing const *ring) {
+    return atomic_ops_load_acquire(&ring->overflow_count);
+}
+
+bool event_ring_check_overflow(EventRing *ring) {
+    size_t const overflow_count = atomic_ops_load_acquire(&ring->overflow_count);
+    bool const overflowed = (overflow_count != ring->checked_overflow_count);
+    ring->checked_overflow_count = overflow_count;
+    return overflowed;
+}
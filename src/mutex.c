@@ -39,10 +39,12 @@ Result mutex_acquire(Mutex *mutex, PlatformTick const timeout) {
 
     while (!acquire_success) {
 
+        platform_enter_critical_section();
         if (mutex->owner == NULL) {
             mutex->owner = coro;
             acquire_success = true;
         }
+        platform_exit_critical_section();
 
         if (!acquire_success) {
             coro_yield_with_signal(CORO_SIG_WAIT);
@@ -58,14 +60,15 @@ Result mutex_acquire(Mutex *mutex, PlatformTick const timeout) {
 }
 
 Result mutex_acquire_no_wait(Mutex *mutex) {
-    // no need locks, mutex operations should only happen within coroutines.
     bool acquired = false;
     Coro *coro = context_get_coro();
 
-    if (mutex->owner != NULL) {
+    platform_enter_critical_section();
+    if (mutex->owner == NULL) {
         mutex->owner = coro;
         acquired = true;
     }
+    platform_exit_critical_section();
 
     return (acquired) ? RES_OK : RES_MUTEX_OCCUPIED;
 }
@@ -73,11 +76,16 @@ Result mutex_acquire_no_wait(Mutex *mutex) {
 Result mutex_release(Mutex *mutex) {
     Coro *coro = context_get_coro();
 
-    if ((mutex->owner != NULL) && (mutex->owner != coro)) {
-        return RES_MUTEX_NOT_OWNER;
+    platform_enter_critical_section();
+    bool const is_owner = (mutex->owner == NULL) || (mutex->owner == coro);
+    if (is_owner) {
+        mutex->owner = NULL;
     }
+    platform_exit_critical_section();
 
-    mutex->owner = NULL;
+    if (!is_owner) {
+        return RES_MUTEX_NOT_OWNER;
+    }
 
     CoroEventSource const event_source = {.type = CORO_EVTSRC_MUTEX_RELEASE,
                                           .params.subject = mutex};
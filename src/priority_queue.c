@@ -0,0 +1,336 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Priority queue implementation, a binary heap of nodes over an item buffer.
+ *
+ * Items stay in their slot of the item buffer, only the nodes move in the heap. The
+ * nodes past the item count hold the free slots: putting an item uses the slot of the
+ * first unused node, and getting one swaps the root with the last used node, handing
+ * its slot back.
+ */
+
+#include <poco/context.h>
+#include <poco/coro.h>
+#include <poco/coro_raw.h>
+#include <poco/intracoro.h>
+#include <poco/priority_queue.h>
+#include <poco/scheduler.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*!
+ * @brief Checks if the first node is got before the second.
+ */
+static bool _is_before(PriorityQueueNode const *first,
+                       PriorityQueueNode const *second) {
+    if (first->priority != second->priority) {
+        return first->priority > second->priority;
+    }
+
+    /* Same priority, the oldest first. The sequence wraps, compare the distance. */
+    return (int32_t)(first->sequence - second->sequence) < 0;
+}
+
+static void _swap(PriorityQueueNode *first, PriorityQueueNode *second) {
+    PriorityQueueNode const temp = *first;
+    *first = *second;
+    *second = temp;
+}
+
+static void _sift_up(PriorityQueue *queue, size_t idx) {
+    while (idx > 0) {
+        size_t const parent = (idx - 1) / 2;
+        if (!_is_before(&queue->nodes[idx], &queue->nodes[parent])) {
+            break;
+        }
+        _swap(&queue->nodes[idx], &queue->nodes[parent]);
+        idx = parent;
+    }
+}
+
+static void _sift_down(PriorityQueue *queue, size_t idx) {
+    size_t const count = queue->count;
+
+    while (1) {
+        size_t first = idx;
+        size_t const left = (2 * idx) + 1;
+        size_t const right = left + 1;
+
+        if ((left < count) && _is_before(&queue->nodes[left], &queue->nodes[first])) {
+            first = left;
+        }
+        if ((right < count) && _is_before(&queue->nodes[right], &queue->nodes[first])) {
+            first = right;
+        }
+        if (first == idx) {
+            break;
+        }
+        _swap(&queue->nodes[idx], &queue->nodes[first]);
+        idx = first;
+    }
+}
+
+/*!
+ * @brief Unsafe push, does not perform checking and is for internal use only.
+ */
+static void _put(PriorityQueue *queue, void const *item, uint32_t const priority) {
+    size_t const idx = queue->count;
+    PriorityQueueNode *node = &queue->nodes[idx];
+
+    memcpy(&queue->item_buffer[node->slot * queue->item_size], item, queue->item_size);
+    node->priority = priority;
+    node->sequence = queue->next_sequence++;
+    queue->count = idx + 1;
+    _sift_up(queue, idx);
+}
+
+/*!
+ * @brief Unsafe pop, does not perform checking and is for internal use only.
+ */
+static void _get(PriorityQueue *queue, void *item, uint32_t *priority) {
+    PriorityQueueNode const *root = &queue->nodes[0];
+
+    memcpy(item, &queue->item_buffer[root->slot * queue->item_size], queue->item_size);
+    if (priority != NULL) {
+        *priority = root->priority;
+    }
+
+    /* The root's slot moves past the item count, and becomes free. */
+    queue->count--;
+    _swap(&queue->nodes[0], &queue->nodes[queue->count]);
+    _sift_down(queue, 0);
+}
+
+static bool _is_full(PriorityQueue const *queue) {
+    return queue->count == queue->max_items;
+}
+
+static bool _is_empty(PriorityQueue const *queue) { return queue->count == 0; }
+
+PriorityQueue *priority_queue_create_static(PriorityQueue *queue,
+                                            size_t const num_items,
+                                            size_t const item_size,
+                                            uint8_t *item_buffer,
+                                            PriorityQueueNode *nodes) {
+    queue->count = 0;
+    queue->next_sequence = 0;
+    queue->nodes = nodes;
+    queue->item_buffer = item_buffer;
+    queue->item_size = item_size;
+    queue->max_items = num_items;
+
+    for (size_t idx = 0; idx < num_items; ++idx) {
+        nodes[idx].slot = idx;
+    }
+
+    return queue;
+}
+
+PriorityQueue *priority_queue_create(size_t const num_items, size_t const item_size) {
+    PriorityQueue *queue = malloc(sizeof(PriorityQueue));
+    if (queue == NULL) {
+        /* No memory. */
+        return NULL;
+    }
+    uint8_t *item_buffer = malloc(num_items * item_size);
+    if (item_buffer == NULL) {
+        /* No memory. */
+        free(queue);
+        return NULL;
+    }
+    PriorityQueueNode *nodes = malloc(num_items * sizeof(PriorityQueueNode));
+    if (nodes == NULL) {
+        /* No memory. */
+        free(item_buffer);
+        free(queue);
+        return NULL;
+    }
+
+    return priority_queue_create_static(queue, num_items, item_size, item_buffer,
+                                        nodes);
+}
+
+void priority_queue_free(PriorityQueue *queue) {
+    if (queue == NULL) {
+        /* Cannot free null pointer, need a non-null to free the internal buffers. */
+        return;
+    }
+
+    free(queue->nodes);
+    free(queue->item_buffer);
+    free(queue);
+}
+
+size_t priority_queue_item_count(PriorityQueue const *queue) {
+    platform_enter_critical_section();
+    size_t const item_count = queue->count;
+    platform_exit_critical_section();
+    return item_count;
+}
+
+bool priority_queue_is_full(PriorityQueue const *queue) {
+    platform_enter_critical_section();
+    bool const is_full = _is_full(queue);
+    platform_exit_critical_section();
+    return is_full;
+}
+
+bool priority_queue_is_empty(PriorityQueue const *queue) {
+    platform_enter_critical_section();
+    bool const is_empty = _is_empty(queue);
+    platform_exit_critical_section();
+    return is_empty;
+}
+
+/*!
+ * @brief Notifies the scheduler of a queue event, without yielding.
+ */
+static Result _notify(PriorityQueue *queue, CoroEventSourceType const type,
+                      bool const from_isr) {
+    Scheduler *scheduler = context_get_scheduler();
+    CoroEventSource const event = {.type = type, .params.subject = queue};
+    Result const notify_result = (from_isr)
+                                     ? scheduler_notify_from_isr(scheduler, &event)
+                                     : scheduler_notify(scheduler, &event);
+
+    if (notify_result != RES_OK) {
+        /* Critical failure to notify scheduler. */
+        return RES_NOTIFY_FAILED;
+    }
+
+    return RES_OK;
+}
+
+Result priority_queue_put(PriorityQueue *queue, void const *item,
+                          uint32_t const priority, PlatformTick const timeout) {
+    Coro *coro = context_get_coro();
+    bool put_success = false;
+
+    coro->event_sinks[EVENT_SINK_SLOT_PRIMARY].type = CORO_EVTSINK_QUEUE_NOT_FULL;
+    coro->event_sinks[EVENT_SINK_SLOT_PRIMARY].params.subject = queue;
+    coro->event_sinks[EVENT_SINK_SLOT_TIMEOUT].type = CORO_EVTSINK_DELAY;
+    coro->event_sinks[EVENT_SINK_SLOT_TIMEOUT].params.ticks_remaining = timeout;
+
+    while (!put_success) {
+
+        platform_enter_critical_section();
+        if (!_is_full(queue)) {
+            _put(queue, item, priority);
+            put_success = true;
+        }
+        platform_exit_critical_section();
+
+        if (!put_success) {
+
+            coro_yield_with_signal(CORO_SIG_WAIT);
+
+            if (coro->triggered_event_sink_slot == EVENT_SINK_SLOT_TIMEOUT) {
+                /* Timeout. */
+                break;
+            }
+        }
+    }
+
+    if (put_success) {
+        coro->event_source.type = CORO_EVTSRC_QUEUE_PUT;
+        coro->event_source.params.subject = queue;
+        coro_yield_with_signal(CORO_SIG_NOTIFY);
+    }
+
+    return (put_success) ? RES_OK : RES_TIMEOUT;
+}
+
+Result priority_queue_put_no_wait(PriorityQueue *queue, void const *item,
+                                  uint32_t const priority) {
+    bool put_success = false;
+
+    platform_enter_critical_section();
+    if (!_is_full(queue)) {
+        _put(queue, item, priority);
+        put_success = true;
+    }
+    platform_exit_critical_section();
+
+    if (!put_success) {
+        return RES_QUEUE_FULL;
+    }
+
+    return _notify(queue, CORO_EVTSRC_QUEUE_PUT, false);
+}
+
+Result priority_queue_put_from_isr(PriorityQueue *queue, void const *item,
+                                   uint32_t const priority) {
+    if (_is_full(queue)) {
+        return RES_QUEUE_FULL;
+    }
+
+    _put(queue, item, priority);
+    return _notify(queue, CORO_EVTSRC_QUEUE_PUT, true);
+}
+
+Result priority_queue_get(PriorityQueue *queue, void *item, uint32_t *priority,
+                          PlatformTick const timeout) {
+    Coro *coro = context_get_coro();
+    bool get_success = false;
+
+    coro->event_sinks[EVENT_SINK_SLOT_PRIMARY].type = CORO_EVTSINK_QUEUE_NOT_EMPTY;
+    coro->event_sinks[EVENT_SINK_SLOT_PRIMARY].params.subject = queue;
+    coro->event_sinks[EVENT_SINK_SLOT_TIMEOUT].type = CORO_EVTSINK_DELAY;
+    coro->event_sinks[EVENT_SINK_SLOT_TIMEOUT].params.ticks_remaining = timeout;
+
+    while (!get_success) {
+
+        platform_enter_critical_section();
+        if (!_is_empty(queue)) {
+            _get(queue, item, priority);
+            get_success = true;
+        }
+        platform_exit_critical_section();
+
+        if (!get_success) {
+            coro_yield_with_signal(CORO_SIG_WAIT);
+
+            if (coro->triggered_event_sink_slot == EVENT_SINK_SLOT_TIMEOUT) {
+                /* Timeout. */
+                break;
+            }
+        }
+    }
+
+    if (get_success) {
+        coro->event_source.type = CORO_EVTSRC_QUEUE_GET;
+        coro->event_source.params.subject = queue;
+        coro_yield_with_signal(CORO_SIG_NOTIFY);
+    }
+
+    return (get_success) ? RES_OK : RES_TIMEOUT;
+}
+
+Result priority_queue_get_no_wait(PriorityQueue *queue, void *item,
+                                  uint32_t *priority) {
+    bool get_success = false;
+
+    platform_enter_critical_section();
+    if (!_is_empty(queue)) {
+        _get(queue, item, priority);
+        get_success = true;
+    }
+    platform_exit_critical_section();
+
+    if (!get_success) {
+        return RES_QUEUE_EMPTY;
+    }
+
+    return _notify(queue, CORO_EVTSRC_QUEUE_GET, false);
+}
+
+Result priority_queue_get_from_isr(PriorityQueue *queue, void *item,
+                                   uint32_t *priority) {
+    if (_is_empty(queue)) {
+        return RES_QUEUE_EMPTY;
+    }
+
+    _get(queue, item, priority);
+    return _notify(queue, CORO_EVTSRC_QUEUE_GET, true);
+}
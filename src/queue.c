@@ -34,10 +34,103 @@ static void _get(Queue *queue, void *item) {
     queue->count--;
 }
 
+/*!
+ * @brief Unsafe reserve, hands out the next free slot without queueing it.
+ */
+static void *_reserve(Queue *queue) {
+    queue->put_reserved = true;
+    return &queue->item_buffer[queue->write_idx * queue->item_size];
+}
+
+/*!
+ * @brief Unsafe commit, queues the reserved slot.
+ */
+static void _commit(Queue *queue) {
+    queue->write_idx = (queue->write_idx + 1) % queue->max_items;
+    queue->count++;
+    queue->put_reserved = false;
+}
+
+/*!
+ * @brief Unsafe peek, hands out the oldest item without removing it.
+ */
+static void *_peek(Queue *queue) {
+    queue->get_peeked = true;
+    return &queue->item_buffer[queue->read_idx * queue->item_size];
+}
+
+/*!
+ * @brief Unsafe release, removes the peeked item.
+ */
+static void _release(Queue *queue) {
+    queue->read_idx = (queue->read_idx + 1) % queue->max_items;
+    queue->count--;
+    queue->get_peeked = false;
+}
+
+/*!
+ * @brief Unsafe batch push, copies the items in at most two spans around the wrap.
+ */
+static void _put_many(Queue *queue, uint8_t const *items, size_t const item_count) {
+    size_t const span = queue->max_items - queue->write_idx;
+    size_t const first_count = (item_count < span) ? item_count : span;
+
+    memcpy(&queue->item_buffer[queue->write_idx * queue->item_size], items,
+           first_count * queue->item_size);
+    memcpy(queue->item_buffer, &items[first_count * queue->item_size],
+           (item_count - first_count) * queue->item_size);
+    queue->write_idx = (queue->write_idx + item_count) % queue->max_items;
+    queue->count += item_count;
+}
+
+/*!
+ * @brief Unsafe batch pop, copies the items in at most two spans around the wrap.
+ */
+static void _get_many(Queue *queue, uint8_t *items, size_t const item_count) {
+    size_t const span = queue->max_items - queue->read_idx;
+    size_t const first_count = (item_count < span) ? item_count : span;
+
+    memcpy(items, &queue->item_buffer[queue->read_idx * queue->item_size],
+           first_count * queue->item_size);
+    memcpy(&items[first_count * queue->item_size], queue->item_buffer,
+           (item_count - first_count) * queue->item_size);
+    queue->read_idx = (queue->read_idx + item_count) % queue->max_items;
+    queue->count -= item_count;
+}
+
 static bool _is_full(Queue const *queue) { return queue->count == queue->max_items; }
 
 static bool _is_empty(Queue const *queue) { return queue->count == 0; }
 
+/*!
+ * @brief Checks if an item can be put, a reserved slot is not free to other producers.
+ */
+static bool _can_put(Queue const *queue) {
+    return !_is_full(queue) && !queue->put_reserved;
+}
+
+/*!
+ * @brief Number of items that can be put, none while a slot is reserved.
+ */
+static size_t _free_count(Queue const *queue) {
+    return (queue->put_reserved) ? 0 : queue->max_items - queue->count;
+}
+
+/*!
+ * @brief Number of items that can be got, none while an item is peeked.
+ */
+static size_t _available_count(Queue const *queue) {
+    return (queue->get_peeked) ? 0 : queue->count;
+}
+
+/*!
+ * @brief Checks if an item can be got, a peeked item is not available to other
+ * consumers.
+ */
+static bool _can_get(Queue const *queue) {
+    return !_is_empty(queue) && !queue->get_peeked;
+}
+
 static size_t _item_count(Queue const *queue) { return queue->count; }
 
 Queue *queue_create_static(Queue *queue, size_t const num_items, size_t const item_size,
@@ -48,6 +141,10 @@ Queue *queue_create_static(Queue *queue, size_t const num_items, size_t const it
     queue->write_idx = 0;
     queue->item_size = item_size;
     queue->max_items = num_items;
+    queue->put_reserved = false;
+    queue->get_peeked = false;
+    queue->put_waiting = false;
+    queue->get_waiting = false;
     return queue;
 }
 
@@ -102,7 +199,7 @@ bool queue_is_empty(Queue const *queue) {
 }
 
 Result queue_raw_put(Queue *queue, void const *item) {
-    if (queue_is_full(queue)) {
+    if (!_can_put(queue)) {
         return RES_QUEUE_FULL;
     }
 
@@ -111,7 +208,7 @@ Result queue_raw_put(Queue *queue, void const *item) {
 }
 
 Result queue_raw_get(Queue *queue, void *item) {
-    if (queue_is_empty(queue)) {
+    if (!_can_get(queue)) {
         return RES_QUEUE_EMPTY;
     }
 
@@ -133,9 +230,12 @@ Result queue_put(Queue *queue, void const *item, PlatformTick const timeout) {
     while (!put_success) {
 
         platform_enter_critical_section();
-        if (!_is_full(queue)) {
+        if (_can_put(queue)) {
             _put(queue, item);
             put_success = true;
+        } else if (queue->put_reserved) {
+            /* Woken by the commit, if there is room left. */
+            queue->put_waiting = true;
         }
         platform_exit_critical_section();
 
@@ -165,7 +265,7 @@ Result queue_put_no_wait(Queue *queue, void const *item) {
     bool put_success = false;
 
     platform_enter_critical_section();
-    if (!_is_full(queue)) {
+    if (_can_put(queue)) {
         _put(queue, item);
         put_success = true;
     }
@@ -190,7 +290,7 @@ Result queue_put_from_isr(Queue *queue, void const *item) {
     Scheduler *scheduler = context_get_scheduler();
     bool put_success = false;
 
-    if (!_is_full(queue)) {
+    if (_can_put(queue)) {
         _put(queue, item);
         put_success = true;
     }
@@ -221,9 +321,12 @@ Result queue_get(Queue *queue, void *item, PlatformTick const timeout) {
     while (!get_success) {
 
         platform_enter_critical_section();
-        if (!_is_empty(queue)) {
+        if (_can_get(queue)) {
             _get(queue, item);
             get_success = true;
+        } else if (queue->get_peeked) {
+            /* Woken by the release, if there are items left. */
+            queue->get_waiting = true;
         }
         platform_exit_critical_section();
 
@@ -252,7 +355,7 @@ Result queue_get_no_wait(Queue *queue, void *item) {
     bool get_success = false;
 
     platform_enter_critical_section();
-    if (!_is_empty(queue)) {
+    if (_can_get(queue)) {
         _get(queue, item);
         get_success = true;
     }
@@ -277,7 +380,7 @@ Result queue_get_from_isr(Queue *queue, void *item) {
     Scheduler *scheduler = context_get_scheduler();
     bool get_success = false;
 
-    if (!_is_empty(queue)) {
+    if (_can_get(queue)) {
         _get(queue, item);
         get_success = true;
     }
@@ -295,3 +398,429 @@ Result queue_get_from_isr(Queue *queue, void *item) {
 
     return (get_success) ? RES_OK : RES_QUEUE_EMPTY;
 }
+
+/*!
+ * @brief Notifies the scheduler of a queue event, without yielding.
+ */
+static Result _notify(Queue *queue, CoroEventSourceType const type) {
+    CoroEventSource const event = {.type = type, .params.subject = queue};
+    return scheduler_notify(context_get_scheduler(), &event);
+}
+
+/*!
+ * @brief Commits the reserved slot.
+ *
+ * Producers that blocked behind the reservation wait for a get, which a commit does not
+ * do. They are to be woken with a get event if there is room left.
+ *
+ * @param queue Queue to commit to.
+ * @param[out] wake_producers Set if blocked producers are to be woken.
+ *
+ * @return True if a slot was reserved, and has been committed.
+ */
+static bool _commit_reserved(Queue *queue, bool *wake_producers) {
+    bool committed = false;
+
+    platform_enter_critical_section();
+    if (queue->put_reserved) {
+        _commit(queue);
+        *wake_producers = queue->put_waiting && !_is_full(queue);
+        queue->put_waiting = false;
+        committed = true;
+    }
+    platform_exit_critical_section();
+
+    return committed;
+}
+
+/*!
+ * @brief Releases the peeked item.
+ *
+ * Consumers that blocked behind the peek wait for a put, which a release does not do.
+ * They are to be woken with a put event if there are items left.
+ *
+ * @param queue Queue to release the item of.
+ * @param[out] wake_consumers Set if blocked consumers are to be woken.
+ *
+ * @return True if an item was peeked, and has been released.
+ */
+static bool _release_peeked(Queue *queue, bool *wake_consumers) {
+    bool released = false;
+
+    platform_enter_critical_section();
+    if (queue->get_peeked) {
+        _release(queue);
+        *wake_consumers = queue->get_waiting && !_is_empty(queue);
+        queue->get_waiting = false;
+        released = true;
+    }
+    platform_exit_critical_section();
+
+    return released;
+}
+
+Result queue_put_reserve(Queue *queue, void **slot, PlatformTick const timeout) {
+    Coro *coro = context_get_coro();
+    bool reserved = false;
+
+    coro->event_sinks[EVENT_SINK_SLOT_PRIMARY].type = CORO_EVTSINK_QUEUE_NOT_FULL;
+    coro->event_sinks[EVENT_SINK_SLOT_PRIMARY].params.subject = queue;
+    coro->event_sinks[EVENT_SINK_SLOT_TIMEOUT].type = CORO_EVTSINK_DELAY;
+    coro->event_sinks[EVENT_SINK_SLOT_TIMEOUT].params.ticks_remaining = timeout;
+
+    while (!reserved) {
+
+        platform_enter_critical_section();
+        if (_can_put(queue)) {
+            *slot = _reserve(queue);
+            reserved = true;
+        } else if (queue->put_reserved) {
+            /* Woken by the commit, if there is room left. */
+            queue->put_waiting = true;
+        }
+        platform_exit_critical_section();
+
+        if (!reserved) {
+
+            coro_yield_with_signal(CORO_SIG_WAIT);
+
+            if (coro->triggered_event_sink_slot == EVENT_SINK_SLOT_TIMEOUT) {
+                /* Timeout. */
+                break;
+            }
+        }
+    }
+
+    /* Nothing is visible to consumers until the commit, no notification. */
+    return (reserved) ? RES_OK : RES_TIMEOUT;
+}
+
+Result queue_put_reserve_no_wait(Queue *queue, void **slot) {
+    bool reserved = false;
+
+    platform_enter_critical_section();
+    if (_can_put(queue)) {
+        *slot = _reserve(queue);
+        reserved = true;
+    }
+    platform_exit_critical_section();
+
+    return (reserved) ? RES_OK : RES_QUEUE_FULL;
+}
+
+Result queue_put_commit(Queue *queue) {
+    Coro *coro = context_get_coro();
+    bool wake_producers = false;
+
+    if (!_commit_reserved(queue, &wake_producers)) {
+        return RES_QUEUE_NOT_RESERVED;
+    }
+
+    if (wake_producers && (_notify(queue, CORO_EVTSRC_QUEUE_GET) != RES_OK)) {
+        /* Critical failure to notify scheduler. */
+        return RES_NOTIFY_FAILED;
+    }
+
+    coro->event_source.type = CORO_EVTSRC_QUEUE_PUT;
+    coro->event_source.params.subject = queue;
+    coro_yield_with_signal(CORO_SIG_NOTIFY);
+
+    return RES_OK;
+}
+
+Result queue_put_commit_no_wait(Queue *queue) {
+    bool wake_producers = false;
+
+    if (!_commit_reserved(queue, &wake_producers)) {
+        return RES_QUEUE_NOT_RESERVED;
+    }
+
+    if ((wake_producers && (_notify(queue, CORO_EVTSRC_QUEUE_GET) != RES_OK)) ||
+        (_notify(queue, CORO_EVTSRC_QUEUE_PUT) != RES_OK)) {
+        /* Critical failure to notify scheduler. */
+        return RES_NOTIFY_FAILED;
+    }
+
+    return RES_OK;
+}
+
+Result queue_get_peek(Queue *queue, void **item, PlatformTick const timeout) {
+    Coro *coro = context_get_coro();
+    bool peeked = false;
+
+    coro->event_sinks[EVENT_SINK_SLOT_PRIMARY].type = CORO_EVTSINK_QUEUE_NOT_EMPTY;
+    coro->event_sinks[EVENT_SINK_SLOT_PRIMARY].params.subject = queue;
+    coro->event_sinks[EVENT_SINK_SLOT_TIMEOUT].type = CORO_EVTSINK_DELAY;
+    coro->event_sinks[EVENT_SINK_SLOT_TIMEOUT].params.ticks_remaining = timeout;
+
+    while (!peeked) {
+
+        platform_enter_critical_section();
+        if (_can_get(queue)) {
+            *item = _peek(queue);
+            peeked = true;
+        } else if (queue->get_peeked) {
+            /* Woken by the release, if there are items left. */
+            queue->get_waiting = true;
+        }
+        platform_exit_critical_section();
+
+        if (!peeked) {
+            coro_yield_with_signal(CORO_SIG_WAIT);
+
+            if (coro->triggered_event_sink_slot == EVENT_SINK_SLOT_TIMEOUT) {
+                /* Timeout. */
+                break;
+            }
+        }
+    }
+
+    /* The slot is only freed by the release, no notification. */
+    return (peeked) ? RES_OK : RES_TIMEOUT;
+}
+
+Result queue_get_peek_no_wait(Queue *queue, void **item) {
+    bool peeked = false;
+
+    platform_enter_critical_section();
+    if (_can_get(queue)) {
+        *item = _peek(queue);
+        peeked = true;
+    }
+    platform_exit_critical_section();
+
+    return (peeked) ? RES_OK : RES_QUEUE_EMPTY;
+}
+
+Result queue_get_release(Queue *queue) {
+    Coro *coro = context_get_coro();
+    bool wake_consumers = false;
+
+    if (!_release_peeked(queue, &wake_consumers)) {
+        return RES_QUEUE_NOT_RESERVED;
+    }
+
+    if (wake_consumers && (_notify(queue, CORO_EVTSRC_QUEUE_PUT) != RES_OK)) {
+        /* Critical failure to notify scheduler. */
+        return RES_NOTIFY_FAILED;
+    }
+
+    coro->event_source.type = CORO_EVTSRC_QUEUE_GET;
+    coro->event_source.params.subject = queue;
+    coro_yield_with_signal(CORO_SIG_NOTIFY);
+
+    return RES_OK;
+}
+
+Result queue_get_release_no_wait(Queue *queue) {
+    bool wake_consumers = false;
+
+    if (!_release_peeked(queue, &wake_consumers)) {
+        return RES_QUEUE_NOT_RESERVED;
+    }
+
+    if ((wake_consumers && (_notify(queue, CORO_EVTSRC_QUEUE_PUT) != RES_OK)) ||
+        (_notify(queue, CORO_EVTSRC_QUEUE_GET) != RES_OK)) {
+        /* Critical failure to notify scheduler. */
+        return RES_NOTIFY_FAILED;
+    }
+
+    return RES_OK;
+}
+
+/*!
+ * @brief Checks the minimum count of a blocking batch operation can be satisfied.
+ */
+static bool _is_valid_batch(Queue const *queue, size_t const item_count,
+                            size_t const min_count) {
+    return (min_count > 0) && (min_count <= item_count) &&
+           (min_count <= queue->max_items);
+}
+
+Result queue_put_many(Queue *queue, void const *items, size_t *item_count,
+                      size_t const min_count, PlatformTick const timeout) {
+    Coro *coro = context_get_coro();
+    size_t put_count = 0;
+
+    if (!_is_valid_batch(queue, *item_count, min_count)) {
+        return RES_INVALID_VALUE;
+    }
+
+    coro->event_sinks[EVENT_SINK_SLOT_PRIMARY].type = CORO_EVTSINK_QUEUE_NOT_FULL;
+    coro->event_sinks[EVENT_SINK_SLOT_PRIMARY].params.subject = queue;
+    coro->event_sinks[EVENT_SINK_SLOT_TIMEOUT].type = CORO_EVTSINK_DELAY;
+    coro->event_sinks[EVENT_SINK_SLOT_TIMEOUT].params.ticks_remaining = timeout;
+
+    while (put_count == 0) {
+
+        platform_enter_critical_section();
+        size_t const free_count = _free_count(queue);
+        if (free_count >= min_count) {
+            put_count = (free_count < *item_count) ? free_count : *item_count;
+            _put_many(queue, items, put_count);
+        } else if (queue->put_reserved) {
+            /* Woken by the commit, if there is room left. */
+            queue->put_waiting = true;
+        }
+        platform_exit_critical_section();
+
+        if (put_count == 0) {
+
+            /* Woken by every get, until enough slots are free. */
+            coro_yield_with_signal(CORO_SIG_WAIT);
+
+            if (coro->triggered_event_sink_slot == EVENT_SINK_SLOT_TIMEOUT) {
+                /* Timeout. */
+                break;
+            }
+        }
+    }
+
+    if (put_count > 0) {
+        /* A single notification for the whole batch. */
+        coro->event_source.type = CORO_EVTSRC_QUEUE_PUT;
+        coro->event_source.params.subject = queue;
+        coro_yield_with_signal(CORO_SIG_NOTIFY);
+    }
+
+    *item_count = put_count;
+    return (put_count > 0) ? RES_OK : RES_TIMEOUT;
+}
+
+Result queue_put_many_no_wait(Queue *queue, void const *items, size_t *item_count) {
+    size_t put_count = 0;
+
+    platform_enter_critical_section();
+    size_t const free_count = _free_count(queue);
+    put_count = (free_count < *item_count) ? free_count : *item_count;
+    _put_many(queue, items, put_count);
+    platform_exit_critical_section();
+
+    *item_count = put_count;
+    if (put_count == 0) {
+        return RES_QUEUE_FULL;
+    }
+
+    if (_notify(queue, CORO_EVTSRC_QUEUE_PUT) != RES_OK) {
+        /* Critical failure to notify scheduler. */
+        return RES_NOTIFY_FAILED;
+    }
+
+    return RES_OK;
+}
+
+Result queue_put_many_from_isr(Queue *queue, void const *items, size_t *item_count) {
+    Scheduler *scheduler = context_get_scheduler();
+    size_t const free_count = _free_count(queue);
+    size_t const put_count = (free_count < *item_count) ? free_count : *item_count;
+
+    _put_many(queue, items, put_count);
+
+    *item_count = put_count;
+    if (put_count == 0) {
+        return RES_QUEUE_FULL;
+    }
+
+    CoroEventSource const event = {.type = CORO_EVTSRC_QUEUE_PUT,
+                                   .params.subject = queue};
+    if (scheduler_notify_from_isr(scheduler, &event) != RES_OK) {
+        /* Critical failure to notify scheduler. */
+        return RES_NOTIFY_FAILED;
+    }
+
+    return RES_OK;
+}
+
+Result queue_get_many(Queue *queue, void *items, size_t *item_count,
+                      size_t const min_count, PlatformTick const timeout) {
+    Coro *coro = context_get_coro();
+    size_t get_count = 0;
+
+    if (!_is_valid_batch(queue, *item_count, min_count)) {
+        return RES_INVALID_VALUE;
+    }
+
+    coro->event_sinks[EVENT_SINK_SLOT_PRIMARY].type = CORO_EVTSINK_QUEUE_NOT_EMPTY;
+    coro->event_sinks[EVENT_SINK_SLOT_PRIMARY].params.subject = queue;
+    coro->event_sinks[EVENT_SINK_SLOT_TIMEOUT].type = CORO_EVTSINK_DELAY;
+    coro->event_sinks[EVENT_SINK_SLOT_TIMEOUT].params.ticks_remaining = timeout;
+
+    while (get_count == 0) {
+
+        platform_enter_critical_section();
+        size_t const available_count = _available_count(queue);
+        if (available_count >= min_count) {
+            get_count = (available_count < *item_count) ? available_count : *item_count;
+            _get_many(queue, items, get_count);
+        } else if (queue->get_peeked) {
+            /* Woken by the release, if there are items left. */
+            queue->get_waiting = true;
+        }
+        platform_exit_critical_section();
+
+        if (get_count == 0) {
+            /* Woken by every put, until enough items are queued. */
+            coro_yield_with_signal(CORO_SIG_WAIT);
+
+            if (coro->triggered_event_sink_slot == EVENT_SINK_SLOT_TIMEOUT) {
+                /* Timeout. */
+                break;
+            }
+        }
+    }
+
+    if (get_count > 0) {
+        /* A single notification for the whole batch. */
+        coro->event_source.type = CORO_EVTSRC_QUEUE_GET;
+        coro->event_source.params.subject = queue;
+        coro_yield_with_signal(CORO_SIG_NOTIFY);
+    }
+
+    *item_count = get_count;
+    return (get_count > 0) ? RES_OK : RES_TIMEOUT;
+}
+
+Result queue_get_many_no_wait(Queue *queue, void *items, size_t *item_count) {
+    size_t get_count = 0;
+
+    platform_enter_critical_section();
+    size_t const available_count = _available_count(queue);
+    get_count = (available_count < *item_count) ? available_count : *item_count;
+    _get_many(queue, items, get_count);
+    platform_exit_critical_section();
+
+    *item_count = get_count;
+    if (get_count == 0) {
+        return RES_QUEUE_EMPTY;
+    }
+
+    if (_notify(queue, CORO_EVTSRC_QUEUE_GET) != RES_OK) {
+        /* Critical failure to notify scheduler. */
+        return RES_NOTIFY_FAILED;
+    }
+
+    return RES_OK;
+}
+
+Result queue_get_many_from_isr(Queue *queue, void *items, size_t *item_count) {
+    Scheduler *scheduler = context_get_scheduler();
+    size_t const available_count = _available_count(queue);
+    size_t const get_count =
+        (available_count < *item_count) ? available_count : *item_count;
+
+    _get_many(queue, items, get_count);
+
+    *item_count = get_count;
+    if (get_count == 0) {
+        return RES_QUEUE_EMPTY;
+    }
+
+    CoroEventSource const event = {.type = CORO_EVTSRC_QUEUE_GET,
+                                   .params.subject = queue};
+    if (scheduler_notify_from_isr(scheduler, &event) != RES_OK) {
+        /* Critical failure to notify scheduler. */
+        return RES_NOTIFY_FAILED;
+    }
+
+    return RES_OK;
+}
@@ -12,3 +12,45 @@ void scheduler_run(Scheduler *scheduler) {
     context_set_scheduler(scheduler);
     scheduler->run(scheduler);
 }
+
+/*!
+ * @brief Stack report being filled in.
+ */
+typedef struct stack_report {
+    CoroStackUsage *usages;
+    size_t max_usages;
+    size_t coro_count;
+} StackReport;
+
+static void add_stack_usage(Coro *coro, void *context) {
+    StackReport *report = context;
+
+    if (report->coro_count < report->max_usages) {
+        CoroStackUsage *usage = &report->usages[report->coro_count];
+        usage->coro = coro;
+        /* Stackless coroutines have no stack size to read. */
+        usage->stack_size = (coro->step == NULL) ? coro->stack_size : 0;
+        usage->high_water = coro_stack_high_water(coro);
+    }
+    report->coro_count++;
+}
+
+size_t scheduler_stack_report(Scheduler *scheduler, CoroStackUsage *usages,
+                              size_t const max_usages) {
+    StackReport report = {.usages = usages, .max_usages = max_usages, .coro_count = 0};
+
+    scheduler_for_each_coroutine(scheduler, add_stack_usage, &report);
+
+    return report.coro_count;
+}
+
+Result scheduler_get_stats(Scheduler const *scheduler, SchedulerStats *stats) {
+#ifdef POCO_WITH_STATS
+    *stats = scheduler->stats;
+    return RES_OK;
+#else
+    (void)scheduler;
+    (void)stats;
+    return RES_NOT_SUPPORTED;
+#endif
+}
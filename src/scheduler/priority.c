@@ -0,0 +1,223 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Priority scheduler implementation.
+ *
+ * Only the ready lists are kept here, the rest of the scheduling is done by the
+ * scheduler core.
+ */
+
+#include <poco/event_ring.h>
+#include <poco/scheduler_core.h>
+#include <poco/schedulers/priority.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/*!
+ * @brief Gets the highest set bit of a non-zero ready bitmap.
+ */
+static uint8_t get_highest_level(uint32_t const levels) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint8_t)(31 - __builtin_clz(levels));
+#elif defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanReverse(&index, levels);
+    return (uint8_t)index;
+#else
+    uint8_t level = 31;
+    while ((levels & (UINT32_C(1) << level)) == 0) {
+        level--;
+    }
+    return level;
+#endif
+}
+
+/*!
+ * @brief Places a ready task at the back of the ready list of its priority.
+ */
+static void add_ready_task(PriorityScheduler *scheduler, Coro *task) {
+    list_push_back(&scheduler->ready_tasks[task->priority], &task->list_node);
+    scheduler->ready_levels |= (UINT32_C(1) << task->priority);
+}
+
+/*!
+ * @brief Places a ready task at the front of the ready list of its priority.
+ */
+static void add_next_task(PriorityScheduler *scheduler, Coro *task) {
+    list_push_front(&scheduler->ready_tasks[task->priority], &task->list_node);
+    scheduler->ready_levels |= (UINT32_C(1) << task->priority);
+    if (scheduler->handoff_counts[task->priority] < UINT8_MAX) {
+        scheduler->handoff_counts[task->priority]++;
+    }
+}
+
+/*!
+ * @brief Removes a task from the ready list of its priority, and from the handoff count
+ * of the priority if counted.
+ */
+static void remove_ready_task(PriorityScheduler *scheduler, Coro *task) {
+    if (list_is_in_front(&scheduler->ready_tasks[task->priority], &task->list_node,
+                         scheduler->handoff_counts[task->priority])) {
+        scheduler->handoff_counts[task->priority]--;
+    }
+    list_remove(&task->list_node);
+
+    if (list_is_empty(&scheduler->ready_tasks[task->priority])) {
+        scheduler->ready_levels &= ~(UINT32_C(1) << task->priority);
+        scheduler->handoff_counts[task->priority] = 0;
+    }
+}
+
+static Coro *get_next_ready_task(PriorityScheduler *scheduler) {
+    if (scheduler->ready_levels == 0) {
+        return NULL;
+    }
+
+    uint8_t const level = get_highest_level(scheduler->ready_levels);
+    ListNode *node = list_pop_front(&scheduler->ready_tasks[level]);
+
+    if (scheduler->handoff_counts[level] > 0) {
+        scheduler->handoff_counts[level]--;
+        scheduler->core.handoff_streak++;
+    } else {
+        scheduler->core.handoff_streak = 0;
+    }
+
+    if (list_is_empty(&scheduler->ready_tasks[level])) {
+        scheduler->ready_levels &= ~(UINT32_C(1) << level);
+        scheduler->handoff_counts[level] = 0;
+    }
+
+    return LIST_CONTAINER_OF(node, Coro, list_node);
+}
+
+static SchedulerCorePolicy const priority_policy = {
+    .add_ready_task = (SchedulerCoreAddTask)add_ready_task,
+    .add_next_task = (SchedulerCoreAddTask)add_next_task,
+    .get_next_ready_task = (SchedulerCoreGetTask)get_next_ready_task,
+    .remove_ready_task = (SchedulerCoreRemoveTask)remove_ready_task,
+    .event_hook = NULL,
+};
+
+Scheduler *priority_scheduler_create(Coro *const *coro_list, uint8_t const *priorities,
+                                     size_t const num_coros) {
+    PriorityScheduler *scheduler = malloc(sizeof(PriorityScheduler));
+
+    if (scheduler == NULL) {
+        /* No more memory. */
+        return NULL;
+    }
+
+    Coro **copied_list = malloc(num_coros * sizeof(Coro *));
+
+    if (copied_list == NULL) {
+        /* No more memory. */
+        free(scheduler);
+        return NULL;
+    }
+
+    EventRingSlot *event_slots =
+        malloc(SCHEDULER_MAX_EXTERNAL_EVENT_COUNT * sizeof(EventRingSlot));
+
+    if (event_slots == NULL) {
+        /* No more memory. */
+        free(copied_list);
+        free(scheduler);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < num_coros; ++i) {
+        copied_list[i] = coro_list[i];
+    }
+
+    Scheduler *created = priority_scheduler_create_static(
+        scheduler, copied_list, priorities, num_coros, event_slots,
+        SCHEDULER_MAX_EXTERNAL_EVENT_COUNT);
+
+    if (created == NULL) {
+        /* Invalid priorities, or external event count. */
+        free(event_slots);
+        free(copied_list);
+        free(scheduler);
+    }
+
+    return created;
+}
+
+Scheduler *priority_scheduler_create_static(PriorityScheduler *scheduler,
+                                            Coro **coro_list,
+                                            uint8_t const *priorities,
+                                            size_t const num_coros,
+                                            EventRingSlot *event_slots,
+                                            size_t const event_slot_count) {
+    for (size_t idx = 0; idx < num_coros; ++idx) {
+        if ((coro_list[idx] != NULL) &&
+            (priorities[idx] >= PRIORITY_SCHEDULER_LEVEL_COUNT)) {
+            return NULL;
+        }
+    }
+
+    scheduler->ready_levels = 0;
+    for (size_t level = 0; level < PRIORITY_SCHEDULER_LEVEL_COUNT; ++level) {
+        list_init(&scheduler->ready_tasks[level]);
+        scheduler->handoff_counts[level] = 0;
+    }
+    /* Priorities are matched by index, set them before the core packs the tasks. */
+    for (size_t idx = 0; idx < num_coros; ++idx) {
+        if (coro_list[idx] != NULL) {
+            coro_list[idx]->priority = priorities[idx];
+        }
+    }
+
+    if (scheduler_core_init(&scheduler->core, &priority_policy, coro_list, num_coros,
+                            event_slots, event_slot_count) != RES_OK) {
+        return NULL;
+    }
+
+    return (Scheduler *)scheduler;
+}
+
+void priority_scheduler_free(PriorityScheduler *scheduler) {
+    if (scheduler == NULL) {
+        /* Cannot free null pointer. */
+        return;
+    }
+
+    scheduler_core_destroy(&scheduler->core);
+
+    if (scheduler->core.tasks != NULL) {
+        /* Note we don't free the underlying coroutines, just the scheduler! */
+        free(scheduler->core.tasks);
+    }
+
+    free(scheduler->core.external_events.slots);
+
+    free(scheduler);
+}
+
+Result priority_scheduler_add_coro(PriorityScheduler *scheduler, Coro *coro,
+                                   uint8_t const priority) {
+    if (priority >= PRIORITY_SCHEDULER_LEVEL_COUNT) {
+        return RES_INVALID_VALUE;
+    }
+
+    coro->priority = priority;
+    return scheduler_core_add_coro(&scheduler->core, coro);
+}
+
+void priority_scheduler_remove_coro(PriorityScheduler *scheduler, Coro const *coro) {
+    scheduler_core_remove_coro(&scheduler->core, coro);
+}
+
+void priority_scheduler_set_reaper(PriorityScheduler *scheduler, SchedulerReaper reaper,
+                                   void *context) {
+    scheduler->core.reaper = reaper;
+    scheduler->core.reaper_context = context;
+}
+
+void priority_scheduler_set_handoff(PriorityScheduler *scheduler, bool enabled) {
+    scheduler->core.handoff = enabled;
+}
@@ -0,0 +1,443 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Shared scheduler core implementation.
+ */
+
+#include <poco/coro_raw.h>
+#include <poco/event_ring.h>
+#include <poco/platform.h>
+#include <poco/scheduler_core.h>
+#include <poco/timer_heap.h>
+#include <poco/wait_table.h>
+
+static Coro *get_current_coro(SchedulerCore const *core) { return core->current_task; }
+
+static void for_each_coro(SchedulerCore const *core, SchedulerCoroutineVisitor visitor,
+                          void *context) {
+    for (size_t idx = 0; idx < core->all_tasks; ++idx) {
+        visitor(core->tasks[idx], context);
+    }
+}
+
+/*!
+ * @brief Moves the tasks to the front of the task table, recording their index.
+ *
+ * @return Number of tasks in the table.
+ */
+static size_t pack_tasks(Coro **coro_list, size_t const max_count) {
+    size_t task_count = 0;
+    for (size_t idx = 0; idx < max_count; ++idx) {
+        Coro *task = coro_list[idx];
+        if (task != NULL) {
+            coro_list[idx] = NULL;
+            coro_list[task_count] = task;
+            task->task_index = task_count++;
+        }
+    }
+    return task_count;
+}
+
+/*!
+ * @brief Releases the task table slot of a task, moving the last task into it.
+ */
+static void release_task_slot(SchedulerCore *core, Coro const *task) {
+    Coro *last_task = core->tasks[--core->all_tasks];
+
+    core->tasks[task->task_index] = last_task;
+    last_task->task_index = task->task_index;
+    core->tasks[core->all_tasks] = NULL;
+}
+
+/*!
+ * @brief Starts tracking the timeout of a task that has just blocked.
+ *
+ * Timeouts are converted from the remaining ticks in the timeout sink into an absolute
+ * deadline.
+ */
+static void add_task_timeout(SchedulerCore *core, Coro *task) {
+    CoroEventSink const *sink = &task->event_sinks[EVENT_SINK_SLOT_TIMEOUT];
+
+    if ((sink->type != CORO_EVTSINK_DELAY) ||
+        (sink->params.ticks_remaining == PLATFORM_TICKS_FOREVER)) {
+        return;
+    }
+
+    PlatformTick const ticks_remaining =
+        (sink->params.ticks_remaining > 0) ? sink->params.ticks_remaining : 0;
+
+    timer_heap_insert(&core->timers, &task->timer_node,
+                      core->current_ticks + ticks_remaining);
+}
+
+/*!
+ * @brief Stops tracking the timeout of a task unblocked by another sink.
+ *
+ * The unused portion of the timeout is written back to the timeout sink, so blocking
+ * again on the same sinks continues the original timeout.
+ */
+static void cancel_task_timeout(SchedulerCore *core, Coro *task) {
+    if (!timer_node_is_linked(&task->timer_node)) {
+        return;
+    }
+
+    PlatformTick const ticks_remaining =
+        task->timer_node.deadline - core->current_ticks;
+    task->event_sinks[EVENT_SINK_SLOT_TIMEOUT].params.ticks_remaining =
+        (ticks_remaining > 0) ? ticks_remaining : 0;
+
+    timer_heap_remove(&core->timers, &task->timer_node);
+}
+
+/*!
+ * @brief Places the unblocked tasks with the policy, in the order they were unblocked.
+ */
+static void add_unblocked_tasks(SchedulerCore *core, ListNode *unblocked,
+                                bool handoff) {
+    ListNode *node = NULL;
+    while ((node = list_pop_front(unblocked)) != NULL) {
+        Coro *task = LIST_CONTAINER_OF(node, Coro, list_node);
+        cancel_task_timeout(core, task);
+        if (handoff) {
+            core->policy->add_next_task(core, task);
+            handoff = false;
+        } else {
+            core->policy->add_ready_task(core, task);
+        }
+    }
+}
+
+/*!
+ * @brief Unblocks the tasks waiting on the event, into the unblocked list.
+ *
+ * @return Number of tasks unblocked.
+ */
+static size_t notify_waiting_tasks(SchedulerCore *core, CoroEventSource const *event,
+                                   ListNode *unblocked) {
+    size_t const unblocked_count =
+        wait_table_notify(&core->wait_table, event, unblocked);
+
+    if (core->policy->event_hook != NULL) {
+        core->policy->event_hook(core, event);
+    }
+
+    return unblocked_count;
+}
+
+Result scheduler_core_init(SchedulerCore *core, SchedulerCorePolicy const *policy,
+                           Coro **coro_list, size_t const num_coros,
+                           EventRingSlot *event_slots, size_t const event_slot_count) {
+    if (event_ring_create_static(&core->external_events, event_slots,
+                                 event_slot_count) == NULL) {
+        return RES_INVALID_VALUE;
+    }
+
+    core->scheduler.run = (SchedulerRun)scheduler_core_run;
+    core->scheduler.notify_from_isr =
+        (SchedulerNotifyFromISR)scheduler_core_notify_from_isr;
+    core->scheduler.notify = (SchedulerNotify)scheduler_core_notify;
+    core->scheduler.get_current_coroutine =
+        (SchedulerGetCurrentCoroutine)get_current_coro;
+    core->scheduler.for_each_coroutine = (SchedulerForEachCoroutine)for_each_coro;
+    scheduler_stats_init(&core->scheduler);
+    core->policy = policy;
+    core->tasks = coro_list;
+    core->max_tasks_count = num_coros;
+    core->all_tasks = pack_tasks(coro_list, num_coros);
+    core->finished_tasks = 0;
+    core->current_task = NULL;
+    core->reaper = NULL;
+    core->reaper_context = NULL;
+    core->handoff = false;
+    core->handoff_streak = 0;
+
+    for (size_t idx = 0; idx < core->all_tasks; ++idx) {
+        Coro *task = coro_list[idx];
+        if (task->coro_state == CORO_STATE_READY) {
+            policy->add_ready_task(core, task);
+        }
+    }
+
+    wait_table_init(&core->wait_table);
+    timer_heap_init(&core->timers);
+    core->current_ticks = 0;
+    platform_idle_init(&core->idle);
+
+    return RES_OK;
+}
+
+void scheduler_core_destroy(SchedulerCore *core) { platform_idle_destroy(&core->idle); }
+
+Result scheduler_core_add_coro(SchedulerCore *core, Coro *coro) {
+    if (core->all_tasks >= core->max_tasks_count) {
+        return RES_NO_MEM;
+    }
+
+    /* Tasks are packed at the front of the table, the next slot is always free. */
+    coro->task_index = core->all_tasks;
+    core->tasks[core->all_tasks++] = coro;
+
+    if (coro->coro_state == CORO_STATE_READY) {
+        core->policy->add_ready_task(core, coro);
+    } else if (coro->coro_state == CORO_STATE_FINISHED) {
+        core->finished_tasks++;
+    }
+
+    return RES_OK;
+}
+
+void scheduler_core_remove_coro(SchedulerCore *core, Coro const *coro) {
+    size_t const idx = coro->task_index;
+
+    if ((idx >= core->all_tasks) || (core->tasks[idx] != coro)) {
+        /* Not managed by this scheduler. */
+        return;
+    }
+
+    Coro *task = core->tasks[idx];
+
+    /* Either in a ready list or a wait list. */
+    if (list_node_is_linked(&task->list_node)) {
+        if (task->coro_state == CORO_STATE_READY) {
+            core->policy->remove_ready_task(core, task);
+        } else {
+            list_remove(&task->list_node);
+        }
+    }
+    if (timer_node_is_linked(&task->timer_node)) {
+        timer_heap_remove(&core->timers, &task->timer_node);
+    }
+    if (task->coro_state == CORO_STATE_FINISHED) {
+        /* No longer counted as a finished task either. */
+        core->finished_tasks--;
+    }
+
+    release_task_slot(core, task);
+}
+
+void scheduler_core_start(SchedulerCore *core) {
+    size_t finished_tasks = 0;
+    for (size_t idx = 0; idx < core->all_tasks; ++idx) {
+        if (core->tasks[idx]->coro_state == CORO_STATE_FINISHED) {
+            finished_tasks++;
+        }
+    }
+    core->finished_tasks = finished_tasks;
+    core->current_ticks = platform_get_monotonic_ticks();
+}
+
+void scheduler_core_block_task(SchedulerCore *core, Coro *task) {
+    wait_table_add(&core->wait_table, task);
+    add_task_timeout(core, task);
+}
+
+size_t scheduler_core_update_waiting_tasks(SchedulerCore *core,
+                                           CoroEventSource const *event,
+                                           bool const handoff) {
+    ListNode unblocked;
+    list_init(&unblocked);
+
+    size_t const unblocked_count = notify_waiting_tasks(core, event, &unblocked);
+    add_unblocked_tasks(core, &unblocked, handoff);
+
+    return unblocked_count;
+}
+
+void scheduler_core_update_expired_tasks(SchedulerCore *core) {
+    TimerNode *timer = NULL;
+    while ((timer = timer_heap_pop_expired(&core->timers, core->current_ticks)) !=
+           NULL) {
+        Coro *task = LIST_CONTAINER_OF(timer, Coro, timer_node);
+        if (coro_notify_timeout(task)) {
+            /* Timed out, no longer waiting on the subject. */
+            wait_table_remove(task);
+            core->policy->add_ready_task(core, task);
+        }
+    }
+}
+
+void scheduler_core_update_external_events(SchedulerCore *core) {
+    EventRing *ring = &core->external_events;
+    CoroEventSource event;
+
+    for (size_t idx = 0; idx <= ring->mask; ++idx) {
+        if (event_ring_get(ring, &event) != RES_OK) {
+            break;
+        }
+        scheduler_core_update_waiting_tasks(core, &event, false);
+    }
+
+    if (event_ring_check_overflow(ring)) {
+        scheduler_stats_add_overflow(&core->scheduler);
+        ListNode unblocked;
+        list_init(&unblocked);
+
+        wait_table_notify_all(&core->wait_table, &unblocked);
+        add_unblocked_tasks(core, &unblocked, false);
+
+        if (core->policy->event_hook != NULL) {
+            core->policy->event_hook(core, NULL);
+        }
+    }
+}
+
+PlatformTick scheduler_core_next_timeout(SchedulerCore const *core) {
+    TimerNode const *next_timer = timer_heap_peek(&core->timers);
+
+    if (next_timer == NULL) {
+        return PLATFORM_TICKS_FOREVER;
+    }
+
+    PlatformTick const timeout = next_timer->deadline - core->current_ticks;
+    return (timeout > 0) ? timeout : 0;
+}
+
+Result scheduler_core_notify_from_isr(SchedulerCore *core,
+                                      CoroEventSource const *event) {
+    Result const put_result = event_ring_put(&core->external_events, event);
+
+    /* The scheduler may be idle, waiting for this event, or needs to recover from the
+     * dropped event. */
+    platform_idle_wake(&core->idle);
+
+    return (put_result == RES_OK) ? RES_OK : RES_NOTIFY_FAILED;
+}
+
+Result scheduler_core_notify(SchedulerCore *core, CoroEventSource const *event) {
+    /* The ring is lock-free, no critical section needed. */
+    Result const put_result = event_ring_put(&core->external_events, event);
+    return (put_result == RES_OK) ? RES_OK : RES_NOTIFY_FAILED;
+}
+
+/*!
+ * @brief Checks if the running task may hand off, without starving the other tasks.
+ */
+static bool can_hand_off(SchedulerCore const *core) {
+    return core->handoff && (core->handoff_streak < SCHEDULER_HANDOFF_LIMIT);
+}
+
+/*!
+ * @brief Moves the task the running task yielded to at the front of the ready list.
+ */
+static void hand_off_to(SchedulerCore *core, Coro *target) {
+    if ((target->coro_state != CORO_STATE_READY) ||
+        !list_node_is_linked(&target->list_node)) {
+        /* Not waiting to run, nothing to hand off to. */
+        return;
+    }
+
+    core->policy->remove_ready_task(core, target);
+    core->policy->add_next_task(core, target);
+}
+
+/*!
+ * @brief Blocks until the next timeout is due, or an external event is received.
+ *
+ * Only called when no task is ready, in which case only an expiring timeout or an
+ * external event can make progress.
+ */
+static void wait_for_next_event(SchedulerCore *core) {
+    if (!event_ring_is_empty(&core->external_events)) {
+        return;
+    }
+
+    PlatformTick const timeout = scheduler_core_next_timeout(core);
+    if (timeout == 0) {
+        return;
+    }
+
+    int64_t const idle_start = scheduler_stats_now();
+    platform_idle_wait(&core->idle, timeout);
+    scheduler_stats_add_idle(&core->scheduler, idle_start);
+    core->current_ticks = platform_get_monotonic_ticks();
+}
+
+/*!
+ * @brief Removes a finished task, and hands it over to the reaper.
+ *
+ * Tasks waiting for it to finish have already been notified.
+ */
+static void reap_task(SchedulerCore *core, Coro *task) {
+    scheduler_core_remove_coro(core, task);
+    core->current_task = NULL;
+    core->reaper(task, core->reaper_context);
+}
+
+static bool run_scheduler_once(SchedulerCore *core) {
+    if (core->finished_tasks >= core->all_tasks) {
+        /* no more tasks to run */
+        return false;
+    }
+
+    scheduler_stats_add_pass(&core->scheduler);
+    Coro *next_coro = core->policy->get_next_ready_task(core);
+    core->current_task = next_coro;
+    // If there are no tasks to run, we can just wait for the next event.
+    if (next_coro != NULL) {
+        CoroSignal const signal = coro_resume(next_coro);
+
+        CoroEventSource const *coroutine_event = NULL;
+
+        switch (signal) {
+        case CORO_SIG_NOTIFY_AND_DONE:
+            core->finished_tasks++;
+            /* FALLTHROUGH */
+        case CORO_SIG_NOTIFY:
+            /* FALLTHROUGH */
+        case CORO_SIG_NOTIFY_AND_WAIT:
+            coroutine_event = &next_coro->event_source;
+            break;
+        case CORO_SIG_WAIT:
+            // do nothing, unblock if an event is triggered.
+            break;
+        }
+
+        core->current_ticks = platform_get_monotonic_ticks();
+
+        if (next_coro->coro_state == CORO_STATE_BLOCKED) {
+            scheduler_core_block_task(core, next_coro);
+        }
+
+        ListNode unblocked;
+        list_init(&unblocked);
+        size_t const unblocked_count =
+            (coroutine_event != NULL)
+                ? notify_waiting_tasks(core, coroutine_event, &unblocked)
+                : 0;
+
+        /* A task waking another keeps its turn, behind the first task it woke. */
+        bool const handoff = (unblocked_count > 0) && can_hand_off(core);
+
+        if ((next_coro->coro_state == CORO_STATE_READY) && handoff) {
+            core->policy->add_next_task(core, next_coro);
+        } else if (next_coro->coro_state == CORO_STATE_READY) {
+            core->policy->add_ready_task(core, next_coro);
+        }
+        add_unblocked_tasks(core, &unblocked, handoff);
+        if (next_coro->yield_target != NULL) {
+            hand_off_to(core, next_coro->yield_target);
+        }
+        if ((signal == CORO_SIG_NOTIFY_AND_DONE) && (core->reaper != NULL)) {
+            reap_task(core, next_coro);
+        }
+    } else {
+        core->current_ticks = platform_get_monotonic_ticks();
+        wait_for_next_event(core);
+    }
+
+    scheduler_core_update_external_events(core);
+
+    // Only the timers that are due are visited.
+    scheduler_core_update_expired_tasks(core);
+
+    return true;
+}
+
+void scheduler_core_run(SchedulerCore *core) {
+    bool keep_running = true;
+    scheduler_core_start(core);
+    while (keep_running) {
+        keep_running = run_scheduler_once(core);
+    }
+}
@@ -0,0 +1,460 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Work-stealing scheduler implementation.
+ *
+ * Lock ordering: the scheduler lock may be held while taking a worker lock, never the
+ * other way around. Ready tasks are only ever added with the scheduler lock held, so
+ * idle workers cannot miss a wake-up.
+ *
+ * Events notified from an ISR (or a signal handler) cannot take the scheduler lock,
+ * they go through the lock-free event ring of the core instead, drained by the
+ * workers. One idle worker waits on the platform's idle hook, so these events wake it
+ * up, the others wait on the condition variable.
+ */
+
+#include <poco/coro_raw.h>
+#include <poco/event_ring.h>
+#include <poco/platform.h>
+#include <poco/scheduler_core.h>
+#include <poco/schedulers/work_stealing.h>
+#include <time.h>
+
+/** Worker run by the calling thread, NULL outside of workers. */
+static __thread WorkStealingWorker *current_worker = NULL;
+
+static Coro *get_current_coro(WorkStealingScheduler const *scheduler) {
+    (void)scheduler;
+    if (current_worker == NULL) {
+        return NULL;
+    }
+    return __atomic_load_n(&current_worker->current_task, __ATOMIC_ACQUIRE);
+}
+
+/*!
+ * @brief Checks if a blocked task is in the wait table, so may miss a dropped event.
+ */
+static bool is_waiting_on_subject(Coro const *task) {
+    CoroEventSinkType const type = task->event_sinks[EVENT_SINK_SLOT_PRIMARY].type;
+    return (type != CORO_EVTSINK_NONE) && (type != CORO_EVTSINK_DELAY);
+}
+
+/*!
+ * @brief Places a ready task at the back of a worker's ready list.
+ *
+ * The scheduler lock must be held.
+ */
+static void push_ready_task(WorkStealingWorker *worker, Coro *task) {
+    WorkStealingScheduler *scheduler = worker->scheduler;
+
+    pthread_mutex_lock(&worker->lock);
+    list_push_back(&worker->ready_tasks, &task->list_node);
+    pthread_mutex_unlock(&worker->lock);
+
+    size_t const idle_workers =
+        __atomic_load_n(&scheduler->idle_workers, __ATOMIC_ACQUIRE);
+    if (idle_workers > (scheduler->idle_watched ? 1 : 0)) {
+        pthread_cond_signal(&scheduler->work_available);
+    } else if (scheduler->idle_watched) {
+        /* Only the worker waiting on the idle hook is left to run it. */
+        platform_idle_wake(&scheduler->core.idle);
+    }
+}
+
+/*!
+ * @brief Places a ready task with the calling worker, or spreads them over the workers
+ * outside of the workers.
+ *
+ * The scheduler lock must be held.
+ */
+static void add_ready_task(WorkStealingScheduler *scheduler, Coro *task) {
+    WorkStealingWorker *worker = current_worker;
+
+    if (worker == NULL) {
+        worker = &scheduler->workers[scheduler->next_worker];
+        scheduler->next_worker = (scheduler->next_worker + 1) % scheduler->worker_count;
+    }
+
+    push_ready_task(worker, task);
+}
+
+static Coro *pop_ready_task(WorkStealingWorker *worker) {
+    pthread_mutex_lock(&worker->lock);
+    ListNode *node = list_pop_front(&worker->ready_tasks);
+    pthread_mutex_unlock(&worker->lock);
+
+    return (node != NULL) ? LIST_CONTAINER_OF(node, Coro, list_node) : NULL;
+}
+
+/*!
+ * @brief Takes the next task from the worker's own ready list, or from a peer's.
+ */
+static Coro *get_next_ready_task(WorkStealingWorker *worker) {
+    WorkStealingScheduler *scheduler = worker->scheduler;
+    size_t const worker_index = (size_t)(worker - scheduler->workers);
+
+    for (size_t offset = 0; offset < scheduler->worker_count; ++offset) {
+        size_t const victim = (worker_index + offset) % scheduler->worker_count;
+        Coro *task = pop_ready_task(&scheduler->workers[victim]);
+        if (task != NULL) {
+            return task;
+        }
+    }
+
+    return NULL;
+}
+
+static bool has_ready_tasks(WorkStealingScheduler *scheduler) {
+    bool ready = false;
+    for (size_t idx = 0; (idx < scheduler->worker_count) && !ready; ++idx) {
+        WorkStealingWorker *worker = &scheduler->workers[idx];
+        pthread_mutex_lock(&worker->lock);
+        ready = !list_is_empty(&worker->ready_tasks);
+        pthread_mutex_unlock(&worker->lock);
+    }
+    return ready;
+}
+
+/*!
+ * @brief Checks an event against the tasks still running on other workers, the
+ * scheduler lock must be held.
+ *
+ * Matching tasks are flagged, as they may be about to block on a condition the event
+ * has just changed. If events were dropped, all running tasks are flagged.
+ */
+static void update_running_tasks(WorkStealingScheduler *scheduler,
+                                 CoroEventSource const *event) {
+    for (size_t idx = 0; idx < scheduler->worker_count; ++idx) {
+        WorkStealingWorker *worker = &scheduler->workers[idx];
+        if (event == NULL) {
+            worker->wake_forced = true;
+            continue;
+        }
+        if (worker == current_worker) {
+            /* The notifying task cannot be blocking. */
+            continue;
+        }
+
+        Coro const *running = __atomic_load_n(&worker->current_task, __ATOMIC_ACQUIRE);
+        if ((running != NULL) && coro_event_matches(running, event)) {
+            worker->wake_pending = true;
+            worker->pending_event = *event;
+        }
+    }
+}
+
+static SchedulerCorePolicy const work_stealing_policy = {
+    .add_ready_task = (SchedulerCoreAddTask)add_ready_task,
+    .add_next_task = NULL,
+    .get_next_ready_task = NULL,
+    .remove_ready_task = NULL,
+    .event_hook = (SchedulerCoreEventHook)update_running_tasks,
+};
+
+/*!
+ * @brief Handles events from outside of the workers' yields.
+ *
+ * @note Unlike single threaded schedulers, events are handled immediately, which takes
+ *       the scheduler lock. ISRs go through the core's event ring instead.
+ */
+static Result notify(WorkStealingScheduler *scheduler, CoroEventSource const *event) {
+    pthread_mutex_lock(&scheduler->lock);
+    scheduler->core.current_ticks = platform_get_monotonic_ticks();
+    scheduler_core_update_waiting_tasks(&scheduler->core, event, false);
+    pthread_mutex_unlock(&scheduler->lock);
+
+    return RES_OK;
+}
+
+/*!
+ * @brief Updates the scheduler with the signal a task has just yielded with.
+ */
+static void complete_task(WorkStealingWorker *worker, Coro *task,
+                          CoroSignal const signal) {
+    WorkStealingScheduler *scheduler = worker->scheduler;
+    SchedulerCore *core = &scheduler->core;
+    CoroEventSource const *coroutine_event = NULL;
+
+    pthread_mutex_lock(&scheduler->lock);
+
+    scheduler_stats_add_pass(&core->scheduler);
+    /* Either blocked or ready from here, other workers can no longer race with it. */
+    __atomic_store_n(&worker->current_task, NULL, __ATOMIC_RELEASE);
+    bool const wake_pending = worker->wake_pending;
+    bool const wake_forced = worker->wake_forced;
+    worker->wake_pending = false;
+    worker->wake_forced = false;
+
+    switch (signal) {
+    case CORO_SIG_NOTIFY_AND_DONE:
+        core->finished_tasks++;
+        /* FALLTHROUGH */
+    case CORO_SIG_NOTIFY:
+        /* FALLTHROUGH */
+    case CORO_SIG_NOTIFY_AND_WAIT:
+        coroutine_event = &task->event_source;
+        break;
+    case CORO_SIG_WAIT:
+        // do nothing, unblock if an event is triggered.
+        break;
+    }
+
+    core->current_ticks = platform_get_monotonic_ticks();
+
+    if (task->coro_state == CORO_STATE_READY) {
+        push_ready_task(worker, task);
+    } else if (task->coro_state == CORO_STATE_BLOCKED) {
+        if (wake_pending && coro_notify(task, &worker->pending_event)) {
+            /* The event happened between the task's checks and its yield. */
+            push_ready_task(worker, task);
+        } else if (wake_forced && is_waiting_on_subject(task) && coro_wake(task)) {
+            /* Events may have been dropped meanwhile, check the condition again. */
+            push_ready_task(worker, task);
+        } else {
+            scheduler_core_block_task(core, task);
+        }
+    }
+    if (coroutine_event != NULL) {
+        scheduler_core_update_waiting_tasks(core, coroutine_event, false);
+    }
+
+    scheduler_core_update_external_events(core);
+    scheduler_core_update_expired_tasks(core);
+
+    if (core->finished_tasks >= core->all_tasks) {
+        /* Let idle workers exit. */
+        pthread_cond_broadcast(&scheduler->work_available);
+        platform_idle_wake(&core->idle);
+    }
+
+    pthread_mutex_unlock(&scheduler->lock);
+}
+
+/*!
+ * @brief Waits until a task may be ready, or all tasks are finished.
+ *
+ * @return False once all tasks are finished.
+ */
+static bool wait_for_work(WorkStealingWorker *worker) {
+    WorkStealingScheduler *scheduler = worker->scheduler;
+    SchedulerCore *core = &scheduler->core;
+    bool keep_running = true;
+
+    pthread_mutex_lock(&scheduler->lock);
+
+    scheduler_stats_add_pass(&core->scheduler);
+    core->current_ticks = platform_get_monotonic_ticks();
+    scheduler_core_update_external_events(core);
+    scheduler_core_update_expired_tasks(core);
+
+    if (core->finished_tasks >= core->all_tasks) {
+        keep_running = false;
+    } else if (!has_ready_tasks(scheduler)) {
+        PlatformTick const timeout = scheduler_core_next_timeout(core);
+
+        __atomic_add_fetch(&scheduler->idle_workers, 1, __ATOMIC_ACQ_REL);
+        int64_t const idle_start = scheduler_stats_now();
+        if (!scheduler->idle_watched) {
+            /* Events put in the ring from now on wake this worker up, even before it
+             * starts waiting. */
+            scheduler->idle_watched = true;
+            pthread_mutex_unlock(&scheduler->lock);
+            platform_idle_wait(&core->idle, timeout);
+            pthread_mutex_lock(&scheduler->lock);
+            scheduler->idle_watched = false;
+        } else if (timeout == PLATFORM_TICKS_FOREVER) {
+            pthread_cond_wait(&scheduler->work_available, &scheduler->lock);
+        } else {
+            /* Ticks are milliseconds on this platform. */
+            struct timespec deadline;
+            clock_gettime(CLOCK_MONOTONIC, &deadline);
+            deadline.tv_sec += (time_t)(timeout / 1000);
+            deadline.tv_nsec += (long)(timeout % 1000) * 1000000L;
+            if (deadline.tv_nsec >= 1000000000L) {
+                deadline.tv_sec += 1;
+                deadline.tv_nsec -= 1000000000L;
+            }
+            pthread_cond_timedwait(&scheduler->work_available, &scheduler->lock,
+                                   &deadline);
+        }
+        /* Summed over the workers, the lock is held again here. */
+        scheduler_stats_add_idle(&core->scheduler, idle_start);
+        __atomic_sub_fetch(&scheduler->idle_workers, 1, __ATOMIC_ACQ_REL);
+    }
+
+    pthread_mutex_unlock(&scheduler->lock);
+
+    return keep_running;
+}
+
+static void run_worker(WorkStealingWorker *worker) {
+    bool keep_running = true;
+    current_worker = worker;
+
+    while (keep_running) {
+        Coro *task = get_next_ready_task(worker);
+
+        if (task == NULL) {
+            keep_running = wait_for_work(worker);
+            continue;
+        }
+
+        __atomic_store_n(&worker->current_task, task, __ATOMIC_RELEASE);
+        CoroSignal const signal = coro_resume(task);
+        complete_task(worker, task, signal);
+    }
+
+    current_worker = NULL;
+}
+
+static void *worker_entry(void *context) {
+    run_worker(context);
+    return NULL;
+}
+
+static void run_scheduling_loop(WorkStealingScheduler *scheduler) {
+    scheduler_core_start(&scheduler->core);
+
+    /* The calling thread runs the first worker. */
+    size_t started_workers = 1;
+    while (started_workers < scheduler->worker_count) {
+        WorkStealingWorker *worker = &scheduler->workers[started_workers];
+        if (pthread_create(&worker->thread, NULL, worker_entry, worker) != 0) {
+            /* Run with fewer threads, the remaining ready lists get stolen from. */
+            break;
+        }
+        started_workers++;
+    }
+
+    run_worker(&scheduler->workers[0]);
+
+    for (size_t idx = 1; idx < started_workers; ++idx) {
+        pthread_join(scheduler->workers[idx].thread, NULL);
+    }
+}
+
+Scheduler *work_stealing_scheduler_create(Coro *const *coro_list,
+                                          size_t const num_coros,
+                                          size_t const worker_count) {
+    WorkStealingScheduler *scheduler = malloc(sizeof(WorkStealingScheduler));
+
+    if (scheduler == NULL) {
+        /* No more memory. */
+        return NULL;
+    }
+
+    Coro **copied_list = malloc(num_coros * sizeof(Coro *));
+    WorkStealingWorker *workers = malloc(worker_count * sizeof(WorkStealingWorker));
+    EventRingSlot *event_slots =
+        malloc(SCHEDULER_MAX_EXTERNAL_EVENT_COUNT * sizeof(EventRingSlot));
+
+    if ((copied_list == NULL) || (workers == NULL) || (event_slots == NULL)) {
+        /* No more memory. */
+        free(event_slots);
+        free(copied_list);
+        free(workers);
+        free(scheduler);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < num_coros; ++i) {
+        copied_list[i] = coro_list[i];
+    }
+
+    Scheduler *created = work_stealing_scheduler_create_static(
+        scheduler, copied_list, num_coros, workers, worker_count, event_slots,
+        SCHEDULER_MAX_EXTERNAL_EVENT_COUNT);
+
+    if (created == NULL) {
+        free(event_slots);
+        free(copied_list);
+        free(workers);
+        free(scheduler);
+    }
+
+    return created;
+}
+
+Scheduler *work_stealing_scheduler_create_static(WorkStealingScheduler *scheduler,
+                                                 Coro **coro_list,
+                                                 size_t const num_coros,
+                                                 WorkStealingWorker *workers,
+                                                 size_t const worker_count,
+                                                 EventRingSlot *event_slots,
+                                                 size_t const event_slot_count) {
+    if (worker_count == 0) {
+        return NULL;
+    }
+
+    pthread_condattr_t condition_attributes;
+    pthread_condattr_init(&condition_attributes);
+    /* Timeouts are computed from the monotonic clock. */
+    pthread_condattr_setclock(&condition_attributes, CLOCK_MONOTONIC);
+    int const condition_result =
+        pthread_cond_init(&scheduler->work_available, &condition_attributes);
+    pthread_condattr_destroy(&condition_attributes);
+
+    if (condition_result != 0) {
+        return NULL;
+    }
+
+    if (pthread_mutex_init(&scheduler->lock, NULL) != 0) {
+        pthread_cond_destroy(&scheduler->work_available);
+        return NULL;
+    }
+
+    scheduler->workers = workers;
+    scheduler->worker_count = worker_count;
+    scheduler->next_worker = 0;
+    scheduler->idle_workers = 0;
+    scheduler->idle_watched = false;
+
+    for (size_t idx = 0; idx < worker_count; ++idx) {
+        WorkStealingWorker *worker = &workers[idx];
+        worker->scheduler = scheduler;
+        pthread_mutex_init(&worker->lock, NULL);
+        list_init(&worker->ready_tasks);
+        worker->current_task = NULL;
+        worker->wake_pending = false;
+        worker->wake_forced = false;
+    }
+
+    /* The initial tasks are spread over all workers. */
+    if (scheduler_core_init(&scheduler->core, &work_stealing_policy, coro_list,
+                            num_coros, event_slots, event_slot_count) != RES_OK) {
+        for (size_t idx = 0; idx < worker_count; ++idx) {
+            pthread_mutex_destroy(&workers[idx].lock);
+        }
+        pthread_mutex_destroy(&scheduler->lock);
+        pthread_cond_destroy(&scheduler->work_available);
+        return NULL;
+    }
+
+    scheduler->core.scheduler.run = (SchedulerRun)run_scheduling_loop;
+    scheduler->core.scheduler.notify = (SchedulerNotify)notify;
+    scheduler->core.scheduler.get_current_coroutine =
+        (SchedulerGetCurrentCoroutine)get_current_coro;
+
+    return (Scheduler *)scheduler;
+}
+
+void work_stealing_scheduler_free(WorkStealingScheduler *scheduler) {
+    if (scheduler == NULL) {
+        /* Cannot free null pointer. */
+        return;
+    }
+
+    for (size_t idx = 0; idx < scheduler->worker_count; ++idx) {
+        pthread_mutex_destroy(&scheduler->workers[idx].lock);
+    }
+    pthread_mutex_destroy(&scheduler->lock);
+    pthread_cond_destroy(&scheduler->work_available);
+    scheduler_core_destroy(&scheduler->core);
+
+    /* Note we don't free the underlying coroutines, just the scheduler! */
+    free(scheduler->core.external_events.slots);
+    free(scheduler->workers);
+    free(scheduler->core.tasks);
+    free(scheduler);
+}
@@ -0,0 +1,176 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Shared stack implementation.
+ */
+
+#include <poco/coro_raw.h>
+#include <poco/shared_stack.h>
+#include <stdlib.h>
+#include <string.h>
+
+static uint8_t *get_stack_top(SharedStack const *shared) {
+    return (uint8_t *)(shared->stack + shared->stack_count);
+}
+
+/*!
+ * @brief Copies the frames of the owner to its save buffer, resized to fit.
+ */
+static bool save_owner(SharedStack *shared) {
+    Coro *owner = shared->owner;
+    if ((owner == NULL) || (owner->coro_state == CORO_STATE_FINISHED)) {
+        /* Nothing worth keeping. */
+        return true;
+    }
+
+    uint8_t *const base = (uint8_t *)shared->stack;
+    uint8_t *const top = get_stack_top(shared);
+    uint8_t *low = (uint8_t *)owner->stack_pointer;
+    if ((size_t)(low - base) > SHARED_STACK_SAVE_MARGIN) {
+        low -= SHARED_STACK_SAVE_MARGIN;
+    } else {
+        low = base;
+    }
+
+    size_t const size = (size_t)(top - low);
+    if (size != owner->saved_stack_size) {
+        uint8_t *buffer = realloc(owner->saved_stack, size);
+        if (buffer == NULL) {
+            /* No memory. */
+            return false;
+        }
+        owner->saved_stack = buffer;
+        owner->saved_stack_size = size;
+    }
+
+    memcpy(owner->saved_stack, low, size);
+    return true;
+}
+
+SharedStack *shared_stack_create_static(SharedStack *shared,
+                                        PlatformStackElement *stack,
+                                        size_t stack_count) {
+    if (stack_count < MIN_STACK_SIZE) {
+        /* Invalid stack size. */
+        return NULL;
+    }
+
+    shared->stack = stack;
+    shared->stack_count = stack_count;
+    shared->owner = NULL;
+    shared->platform_stack = false;
+    return shared;
+}
+
+SharedStack *shared_stack_create(size_t stack_count) {
+    if (stack_count < MIN_STACK_SIZE) {
+        /* Invalid stack size. */
+        return NULL;
+    }
+
+    SharedStack *shared = malloc(sizeof(SharedStack));
+    if (shared == NULL) {
+        /* No memory. */
+        return NULL;
+    }
+
+    PlatformStackElement *stack = platform_stack_alloc(stack_count);
+    if (stack == NULL) {
+        /* No memory. */
+        free(shared);
+        return NULL;
+    }
+
+    shared_stack_create_static(shared, stack, stack_count);
+    shared->platform_stack = true;
+    return shared;
+}
+
+void shared_stack_free(SharedStack *shared) {
+    platform_stack_free(shared->stack, shared->stack_count);
+    free(shared);
+}
+
+Coro *coro_create_shared_static(Coro *coro, CoroEntrypoint entrypoint, void *context,
+                                SharedStack *shared) {
+#ifdef PLATFORM_OWN_STACKS
+    /* Frames are not on the shared stack, there is nothing to save nor restore. */
+    (void)coro;
+    (void)entrypoint;
+    (void)context;
+    (void)shared;
+    return NULL;
+#else
+    if ((shared->owner != NULL) && (shared->owner->coro_state == CORO_STATE_RUNNING)) {
+        /* The stack is in use by the caller. */
+        return NULL;
+    }
+
+    if (!save_owner(shared)) {
+        /* No memory. */
+        return NULL;
+    }
+    shared->owner = NULL;
+
+    Coro *created =
+        shared->platform_stack
+            ? coro_create_platform_stack(coro, entrypoint, context, shared->stack,
+                                         shared->stack_count)
+            : coro_create_static(coro, entrypoint, context, shared->stack,
+                                 shared->stack_count);
+    if (created == NULL) {
+        /* Invalid parameters. */
+        return NULL;
+    }
+
+    coro->shared_stack = shared;
+    shared->owner = coro;
+    return coro;
+#endif
+}
+
+Coro *coro_create_shared(CoroEntrypoint entrypoint, void *context,
+                         SharedStack *shared) {
+    Coro *coro = malloc(sizeof(Coro));
+    if (coro == NULL) {
+        /* No memory. */
+        return NULL;
+    }
+
+    if (coro_create_shared_static(coro, entrypoint, context, shared) == NULL) {
+        free(coro);
+        return NULL;
+    }
+
+    return coro;
+}
+
+bool shared_stack_acquire(SharedStack *shared, Coro *coro) {
+    if (shared->owner == coro) {
+        /* Frames already in place. */
+        return true;
+    }
+
+    if (!save_owner(shared)) {
+        /* No memory, the owner keeps the stack. */
+        return false;
+    }
+
+    shared->owner = coro;
+    if (coro->saved_stack_size > 0) {
+        memcpy(get_stack_top(shared) - coro->saved_stack_size, coro->saved_stack,
+               coro->saved_stack_size);
+    }
+    return true;
+}
+
+void shared_stack_release(SharedStack *shared, Coro *coro) {
+    if (shared->owner == coro) {
+        shared->owner = NULL;
+    }
+
+    free(coro->saved_stack);
+    coro->saved_stack = NULL;
+    coro->saved_stack_size = 0;
+}
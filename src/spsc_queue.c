@@ -0,0 +1,187 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Lock-free single-producer single-consumer queue implementation.
+ *
+ * Positions run free and are masked on access. Each side keeps a copy of the other
+ * side's position, and only reads the shared one when its copy says the queue is full
+ * or empty.
+ *
+ * The consumer flags itself as waiting before blocking, then checks the queue again.
+ * The producer publishes the item, then checks the flag. A full fence on both sides
+ * ensures at least one of them sees the other, so the consumer never blocks on an item
+ * it missed.
+ */
+
+#include "atomic_ops.h"
+#include <poco/context.h>
+#include <poco/coro.h>
+#include <poco/coro_raw.h>
+#include <poco/intracoro.h>
+#include <poco/queue.h>
+#include <poco/spsc_queue.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+
+static Scheduler *_load_scheduler(Scheduler *const *value) {
+    return *(Scheduler *const volatile *)value;
+}
+
+static void _store_scheduler(Scheduler **value, Scheduler *scheduler) {
+    *(Scheduler *volatile *)value = scheduler;
+}
+
+#else
+
+static Scheduler *_load_scheduler(Scheduler *const *value) {
+    return __atomic_load_n(value, __ATOMIC_RELAXED);
+}
+
+static void _store_scheduler(Scheduler **value, Scheduler *scheduler) {
+    __atomic_store_n(value, scheduler, __ATOMIC_RELAXED);
+}
+
+#endif
+
+SpscQueue *spsc_queue_create_static(SpscQueue *queue, size_t const num_items,
+                                    size_t const item_size, uint8_t *item_buffer) {
+    if ((num_items == 0) || ((num_items & (num_items - 1)) != 0)) {
+        /* Positions are masked, the number of items must be a power of 2. */
+        return NULL;
+    }
+
+    queue->head = 0;
+    queue->cached_tail = 0;
+    queue->tail = 0;
+    queue->cached_head = 0;
+    queue->scheduler = NULL;
+    queue->waiting = 0;
+    queue->item_buffer = item_buffer;
+    queue->item_size = item_size;
+    queue->mask = num_items - 1;
+    return queue;
+}
+
+SpscQueue *spsc_queue_create(size_t const num_items, size_t const item_size) {
+    SpscQueue *queue = malloc(sizeof(SpscQueue));
+    if (queue == NULL) {
+        /* No memory. */
+        return NULL;
+    }
+    uint8_t *item_buffer = malloc(num_items * item_size);
+    if (item_buffer == NULL) {
+        /* No memory. */
+        free(queue);
+        return NULL;
+    }
+
+    if (spsc_queue_create_static(queue, num_items, item_size, item_buffer) == NULL) {
+        free(item_buffer);
+        free(queue);
+        return NULL;
+    }
+
+    return queue;
+}
+
+void spsc_queue_free(SpscQueue *queue) {
+    if (queue == NULL) {
+        /* Cannot free null pointer, need a non-null to free the internal buffer. */
+        return;
+    }
+
+    free(queue->item_buffer);
+    free(queue);
+}
+
+size_t spsc_queue_item_count(SpscQueue const *queue) {
+    size_t const tail = atomic_ops_load_acquire(&queue->tail);
+    return atomic_ops_load_acquire(&queue->head) - tail;
+}
+
+Result spsc_queue_put(SpscQueue *queue, void const *item) {
+    size_t const head = queue->head;
+
+    if ((head - queue->cached_tail) > queue->mask) {
+        /* Full as last seen, the consumer may have made room since. */
+        queue->cached_tail = atomic_ops_load_acquire(&queue->tail);
+        if ((head - queue->cached_tail) > queue->mask) {
+            return RES_QUEUE_FULL;
+        }
+    }
+
+    memcpy(&queue->item_buffer[(head & queue->mask) * queue->item_size], item,
+           queue->item_size);
+    atomic_ops_store_release(&queue->head, head + 1);
+
+    /* Orders the publication before the check, see spsc_queue_get(). */
+    atomic_ops_fence_full();
+    if ((atomic_ops_load_acquire(&queue->waiting) == 0) ||
+        (atomic_ops_exchange(&queue->waiting, 0) == 0)) {
+        /* The consumer is busy, it will find the item without a wake-up. */
+        return RES_OK;
+    }
+
+    CoroEventSource const event = {.type = CORO_EVTSRC_QUEUE_PUT,
+                                   .params.subject = queue};
+    Scheduler *scheduler = _load_scheduler(&queue->scheduler);
+    if (scheduler_notify_from_isr(scheduler, &event) != RES_OK) {
+        /* Critical failure to notify scheduler. */
+        return RES_NOTIFY_FAILED;
+    }
+
+    return RES_OK;
+}
+
+Result spsc_queue_get_no_wait(SpscQueue *queue, void *item) {
+    size_t const tail = queue->tail;
+
+    if (tail == queue->cached_head) {
+        /* Empty as last seen, the producer may have put items since. */
+        queue->cached_head = atomic_ops_load_acquire(&queue->head);
+        if (tail == queue->cached_head) {
+            return RES_QUEUE_EMPTY;
+        }
+    }
+
+    memcpy(item, &queue->item_buffer[(tail & queue->mask) * queue->item_size],
+           queue->item_size);
+    atomic_ops_store_release(&queue->tail, tail + 1);
+
+    /* The producer never blocks, there is no one to notify. */
+    return RES_OK;
+}
+
+Result spsc_queue_get(SpscQueue *queue, void *item, PlatformTick const timeout) {
+    Coro *coro = context_get_coro();
+
+    coro->event_sinks[EVENT_SINK_SLOT_PRIMARY].type = CORO_EVTSINK_QUEUE_NOT_EMPTY;
+    coro->event_sinks[EVENT_SINK_SLOT_PRIMARY].params.subject = queue;
+    coro->event_sinks[EVENT_SINK_SLOT_TIMEOUT].type = CORO_EVTSINK_DELAY;
+    coro->event_sinks[EVENT_SINK_SLOT_TIMEOUT].params.ticks_remaining = timeout;
+
+    while (spsc_queue_get_no_wait(queue, item) != RES_OK) {
+
+        /* Flag the wait, then check again, as the producer may have missed the flag. */
+        _store_scheduler(&queue->scheduler, context_get_scheduler());
+        (void)atomic_ops_exchange(&queue->waiting, 1);
+        if (spsc_queue_get_no_wait(queue, item) == RES_OK) {
+            atomic_ops_store_release(&queue->waiting, 0);
+            break;
+        }
+
+        coro_yield_with_signal(CORO_SIG_WAIT);
+
+        /* Already cleared by the producer, unless woken by the timeout. */
+        atomic_ops_store_release(&queue->waiting, 0);
+        if (coro->triggered_event_sink_slot == EVENT_SINK_SLOT_TIMEOUT) {
+            /* Timeout. */
+            return RES_TIMEOUT;
+        }
+    }
+
+    return RES_OK;
+}
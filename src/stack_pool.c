@@ -0,0 +1,197 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Stack pool implementation.
+ */
+
+#include <poco/coro_raw.h>
+#include <poco/list.h>
+#include <poco/stack_pool.h>
+
+/*!
+ * @brief Gets the smallest class holding at least stack_count elements.
+ */
+static StackPoolClass *get_class(StackPool *pool, size_t const stack_count) {
+    for (size_t idx = 0; idx < pool->class_count; ++idx) {
+        if (pool->classes[idx].stack_count >= stack_count) {
+            return &pool->classes[idx];
+        }
+    }
+    return NULL;
+}
+
+static void noop_entrypoint(void *context) { (void)context; }
+
+/*!
+ * @brief Allocates a block for the class, and its stack.
+ */
+static StackPoolBlock *allocate_block(StackPoolClass *pool_class) {
+    StackPoolBlock *block = malloc(sizeof(StackPoolBlock));
+    if (block == NULL) {
+        /* No memory. */
+        return NULL;
+    }
+
+    PlatformStackElement *stack = platform_stack_alloc(pool_class->stack_count);
+    if (stack == NULL) {
+        /* No memory. */
+        free(block);
+        return NULL;
+    }
+
+    if (coro_create_platform_stack(&block->coro, noop_entrypoint, NULL, stack,
+                                   pool_class->stack_count) == NULL) {
+        platform_stack_free(stack, pool_class->stack_count);
+        free(block);
+        return NULL;
+    }
+
+    block->next = NULL;
+    pool_class->total_count++;
+    return block;
+}
+
+static void free_block(StackPoolBlock *block) {
+    platform_stack_free(block->coro.stack, block->coro.stack_size);
+    coro_destroy_static(&block->coro);
+    free(block);
+}
+
+static void push_free_block(StackPoolClass *pool_class, StackPoolBlock *block) {
+    block->next = pool_class->free_block;
+    pool_class->free_block = block;
+    pool_class->free_count++;
+}
+
+StackPool *stack_pool_create_static(StackPool *pool, size_t const *stack_counts,
+                                    size_t const class_count) {
+    if ((class_count == 0) || (class_count > STACK_POOL_MAX_CLASS_COUNT)) {
+        return NULL;
+    }
+
+    for (size_t idx = 0; idx < class_count; ++idx) {
+        if ((stack_counts[idx] < 3) ||
+            ((idx > 0) && (stack_counts[idx] <= stack_counts[idx - 1]))) {
+            /* Too small to hold the stack markers, or not in ascending order. */
+            return NULL;
+        }
+    }
+
+    for (size_t idx = 0; idx < class_count; ++idx) {
+        pool->classes[idx].stack_count = stack_counts[idx];
+        pool->classes[idx].free_block = NULL;
+        pool->classes[idx].free_count = 0;
+        pool->classes[idx].total_count = 0;
+    }
+    pool->class_count = class_count;
+
+    return pool;
+}
+
+StackPool *stack_pool_create(size_t const *stack_counts, size_t const class_count) {
+    StackPool *pool = malloc(sizeof(StackPool));
+
+    if (pool == NULL) {
+        /* No more memory. */
+        return NULL;
+    }
+
+    StackPool *created = stack_pool_create_static(pool, stack_counts, class_count);
+
+    if (created == NULL) {
+        /* Invalid classes. */
+        free(pool);
+    }
+
+    return created;
+}
+
+void stack_pool_destroy_static(StackPool *pool) {
+    for (size_t idx = 0; idx < pool->class_count; ++idx) {
+        StackPoolClass *pool_class = &pool->classes[idx];
+        while (pool_class->free_block != NULL) {
+            StackPoolBlock *block = pool_class->free_block;
+            pool_class->free_block = block->next;
+            free_block(block);
+        }
+        pool_class->free_count = 0;
+        pool_class->total_count = 0;
+    }
+}
+
+void stack_pool_free(StackPool *pool) {
+    if (pool == NULL) {
+        /* Cannot free null pointer. */
+        return;
+    }
+
+    stack_pool_destroy_static(pool);
+    free(pool);
+}
+
+Result stack_pool_prewarm(StackPool *pool, size_t const stack_count,
+                          size_t const block_count) {
+    StackPoolClass *pool_class = get_class(pool, stack_count);
+
+    if (pool_class == NULL) {
+        return RES_INVALID_VALUE;
+    }
+
+    while (pool_class->free_count < block_count) {
+        StackPoolBlock *block = allocate_block(pool_class);
+        if (block == NULL) {
+            return RES_NO_MEM;
+        }
+        push_free_block(pool_class, block);
+    }
+
+    return RES_OK;
+}
+
+Coro *stack_pool_coro_create(StackPool *pool, CoroEntrypoint const entrypoint,
+                             void *context, size_t const stack_count) {
+    StackPoolClass *pool_class = get_class(pool, stack_count);
+
+    if (pool_class == NULL) {
+        /* Larger than the largest class. */
+        return NULL;
+    }
+
+    StackPoolBlock *block = pool_class->free_block;
+
+    if (block != NULL) {
+        pool_class->free_block = block->next;
+        pool_class->free_count--;
+    } else {
+        block = allocate_block(pool_class);
+        if (block == NULL) {
+            return NULL;
+        }
+    }
+
+    block->next = NULL;
+    Coro *coro = coro_reset(&block->coro, entrypoint, context);
+
+    if (coro == NULL) {
+        /* Returned while still running, keep it out of the pool. */
+        free_block(block);
+        pool_class->total_count--;
+    }
+
+    return coro;
+}
+
+void stack_pool_coro_free(StackPool *pool, Coro *coro) {
+    if (coro == NULL) {
+        /* Nothing to return. */
+        return;
+    }
+
+    StackPoolBlock *block = LIST_CONTAINER_OF(coro, StackPoolBlock, coro);
+    StackPoolClass *pool_class = get_class(pool, coro->stack_size);
+
+    push_free_block(pool_class, block);
+}
+
+void stack_pool_reap(Coro *coro, void *pool) { stack_pool_coro_free(pool, coro); }
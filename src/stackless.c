@@ -0,0 +1,72 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Stackless coroutine implementation.
+ */
+
+#include <poco/stackless.h>
+
+Coro *coro_create_stackless_static(CoroStackless *storage, CoroStep const step,
+                                   void *context) {
+    if (step == NULL) {
+        return NULL;
+    }
+
+    /* Only the scheduling state is present, the execution state is never touched. */
+    Coro *coro = (Coro *)storage;
+    coro->coro_state = CORO_STATE_READY;
+    coro->step = step;
+    coro->step_context = context;
+    coro->resume_label = 0;
+    list_node_init(&coro->list_node);
+    timer_node_init(&coro->timer_node);
+    coro->priority = 0;
+    coro->task_index = 0;
+    coro->yield_target = NULL;
+    coro_stats_init(coro);
+
+    return coro;
+}
+
+Coro *coro_create_stackless(CoroStep const step, void *context) {
+    CoroStackless *storage = malloc(sizeof(CoroStackless));
+    if (storage == NULL) {
+        /* No memory */
+        return NULL;
+    }
+
+    Coro *coro_handle = coro_create_stackless_static(storage, step, context);
+    if (coro_handle == NULL) {
+        free(storage);
+    }
+
+    return coro_handle;
+}
+
+CoroSignal coro_stackless_yield(Coro *coro) {
+    coro->event_source.type = CORO_EVTSRC_NOOP;
+    return CORO_SIG_NOTIFY;
+}
+
+CoroSignal coro_stackless_delay(Coro *coro, int64_t const duration_ms) {
+    coro->event_sinks[EVENT_SINK_SLOT_PRIMARY].type = CORO_EVTSINK_NONE;
+    coro->event_sinks[EVENT_SINK_SLOT_TIMEOUT].type = CORO_EVTSINK_DELAY;
+    coro->event_sinks[EVENT_SINK_SLOT_TIMEOUT].params.ticks_remaining =
+        duration_ms * platform_get_ticks_per_ms();
+    return CORO_SIG_WAIT;
+}
+
+CoroSignal coro_stackless_wait(Coro *coro, CoroEventSinkType const sink_type,
+                               void *subject) {
+    coro->event_sinks[EVENT_SINK_SLOT_PRIMARY].type = sink_type;
+    coro->event_sinks[EVENT_SINK_SLOT_PRIMARY].params.subject = subject;
+    coro->event_sinks[EVENT_SINK_SLOT_TIMEOUT].type = CORO_EVTSINK_NONE;
+    return CORO_SIG_WAIT;
+}
+
+CoroSignal coro_stackless_finish(Coro *coro) {
+    coro->event_source.type = CORO_EVTSRC_CORO_FINISHED;
+    coro->event_source.params.subject = coro;
+    return CORO_SIG_NOTIFY_AND_DONE;
+}
@@ -70,7 +70,11 @@ void stream_free(Stream *stream) {
 }
 
 size_t stream_bytes_used(Stream const *stream) {
-    return (stream->write_idx - stream->read_idx) % stream->max_size;
+    platform_enter_critical_section();
+    size_t const bytes_used =
+        (stream->write_idx - stream->read_idx) % stream->max_size;
+    platform_exit_critical_section();
+    return bytes_used;
 }
 
 size_t stream_bytes_free(Stream const *stream) {
@@ -107,11 +111,13 @@ Result stream_send(Stream *stream, uint8_t const *data, size_t *data_size,
             }
         }
 
+        platform_enter_critical_section();
         for (size_t count = 0; count < bytes_available; ++count) {
             stream->buffer[stream->write_idx % stream->max_size] =
                 data[bytes_written + count];
             stream->write_idx += 1;
         }
+        platform_exit_critical_section();
         bytes_written += bytes_available;
         bytes_remaining -= bytes_available;
     }
@@ -139,10 +145,12 @@ Result stream_send_no_wait(Stream *stream, uint8_t const *data, size_t *data_siz
         bytes_written = *data_size;
     }
 
+    platform_enter_critical_section();
     for (size_t count = 0; count < bytes_written; ++count) {
         stream->buffer[stream->write_idx % stream->max_size] = data[count];
         stream->write_idx += 1;
     }
+    platform_exit_critical_section();
 
     if (bytes_written > 0) {
         /* Notify the consumer if we have put even a single byte. */
@@ -222,11 +230,13 @@ Result stream_receive(Stream *stream, uint8_t *buffer, size_t *buffer_size,
             }
         }
 
+        platform_enter_critical_section();
         for (size_t count = 0; count < bytes_available; ++count) {
             buffer[bytes_read + count] =
                 stream->buffer[stream->read_idx % stream->max_size];
             stream->read_idx += 1;
         }
+        platform_exit_critical_section();
         /* As we are reading, if they are the same, they must be empty. */
         bytes_read += bytes_available;
         bytes_remaining -= bytes_available;
@@ -268,10 +278,12 @@ Result stream_receive_up_to(Stream *stream, uint8_t *buffer, size_t *buffer_size
         bytes_available = *buffer_size;
     }
 
+    platform_enter_critical_section();
     for (size_t count = 0; count < bytes_available; ++count) {
         buffer[count] = stream->buffer[stream->read_idx % stream->max_size];
         stream->read_idx += 1;
     }
+    platform_exit_critical_section();
 
     if (bytes_available > 0) {
         /* Notify as we have read some data */
@@ -294,10 +306,12 @@ Result stream_receive_no_wait(Stream *stream, uint8_t *buffer, size_t *buffer_si
         bytes_read = *buffer_size;
     }
 
+    platform_enter_critical_section();
     for (size_t count = 0; count < bytes_read; ++count) {
         buffer[count] = stream->buffer[stream->read_idx % stream->max_size];
         stream->read_idx += 1;
     }
+    platform_exit_critical_section();
 
     if (bytes_read > 0) {
         /* Notify the producer if we have taken out any bytes. */
@@ -0,0 +1,144 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Pairing heap implementation for timers.
+ */
+
+#include <poco/timer_heap.h>
+
+/*!
+ * @brief Compares deadlines as differences, so tick overflow is handled.
+ */
+static bool _is_before(PlatformTick const lhs, PlatformTick const rhs) {
+    return (PlatformTick)(lhs - rhs) < 0;
+}
+
+/*!
+ * @brief Links 2 subtrees, the later root becomes the leftmost child of the other.
+ *
+ * @return Root of the combined subtree.
+ */
+static TimerNode *_meld(TimerNode *lhs, TimerNode *rhs) {
+    if (_is_before(rhs->deadline, lhs->deadline)) {
+        TimerNode *temp = lhs;
+        lhs = rhs;
+        rhs = temp;
+    }
+
+    rhs->prev = lhs;
+    rhs->sibling = lhs->child;
+    if (lhs->child != NULL) {
+        lhs->child->prev = rhs;
+    }
+    lhs->child = rhs;
+
+    return lhs;
+}
+
+/*!
+ * @brief Combines a list of siblings into a single subtree using the 2 pass method.
+ *
+ * @return Root of the combined subtree, or NULL if there were no siblings.
+ */
+static TimerNode *_merge_siblings(TimerNode *first) {
+    TimerNode *pairs = NULL;
+
+    /* First pass, meld pairs left to right, stacking the results in reverse order. */
+    while (first != NULL) {
+        TimerNode *lhs = first;
+        TimerNode *rhs = first->sibling;
+
+        if (rhs == NULL) {
+            lhs->sibling = pairs;
+            pairs = lhs;
+            break;
+        }
+
+        first = rhs->sibling;
+        lhs->sibling = NULL;
+        rhs->sibling = NULL;
+
+        TimerNode *melded = _meld(lhs, rhs);
+        melded->sibling = pairs;
+        pairs = melded;
+    }
+
+    if (pairs == NULL) {
+        return NULL;
+    }
+
+    /* Second pass, meld the pairs right to left into a single tree. */
+    TimerNode *root = pairs;
+    pairs = pairs->sibling;
+    root->sibling = NULL;
+
+    while (pairs != NULL) {
+        TimerNode *next = pairs->sibling;
+        pairs->sibling = NULL;
+        root = _meld(root, pairs);
+        pairs = next;
+    }
+
+    return root;
+}
+
+static void _set_root(TimerHeap *heap, TimerNode *root) {
+    if (root != NULL) {
+        root->prev = root;
+        root->sibling = NULL;
+    }
+    heap->root = root;
+}
+
+void timer_heap_init(TimerHeap *heap) { heap->root = NULL; }
+
+void timer_node_init(TimerNode *node) {
+    node->child = NULL;
+    node->sibling = NULL;
+    node->prev = NULL;
+}
+
+void timer_heap_insert(TimerHeap *heap, TimerNode *node, PlatformTick const deadline) {
+    node->deadline = deadline;
+    node->child = NULL;
+    node->sibling = NULL;
+
+    _set_root(heap, (heap->root == NULL) ? node : _meld(heap->root, node));
+}
+
+void timer_heap_remove(TimerHeap *heap, TimerNode *node) {
+    TimerNode *subtree = _merge_siblings(node->child);
+
+    if (node == heap->root) {
+        _set_root(heap, subtree);
+    } else {
+        /* Detach from the parent (if leftmost) or the left sibling. */
+        if (node->prev->child == node) {
+            node->prev->child = node->sibling;
+        } else {
+            node->prev->sibling = node->sibling;
+        }
+
+        if (node->sibling != NULL) {
+            node->sibling->prev = node->prev;
+        }
+
+        if (subtree != NULL) {
+            _set_root(heap, _meld(heap->root, subtree));
+        }
+    }
+
+    timer_node_init(node);
+}
+
+TimerNode *timer_heap_pop_expired(TimerHeap *heap, PlatformTick const now) {
+    TimerNode *root = heap->root;
+
+    if ((root == NULL) || _is_before(now, root->deadline)) {
+        return NULL;
+    }
+
+    timer_heap_remove(heap, root);
+    return root;
+}
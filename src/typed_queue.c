@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Blocking and notification shared by all typed queues.
+ */
+
+#include <poco/context.h>
+#include <poco/coro.h>
+#include <poco/coro_raw.h>
+#include <poco/intracoro.h>
+#include <poco/scheduler.h>
+#include <poco/typed_queue.h>
+
+void typed_queue_prepare_wait(void *queue, CoroEventSinkType const sink_type,
+                              PlatformTick const timeout) {
+    Coro *coro = context_get_coro();
+
+    coro->event_sinks[EVENT_SINK_SLOT_PRIMARY].type = sink_type;
+    coro->event_sinks[EVENT_SINK_SLOT_PRIMARY].params.subject = queue;
+    coro->event_sinks[EVENT_SINK_SLOT_TIMEOUT].type = CORO_EVTSINK_DELAY;
+    coro->event_sinks[EVENT_SINK_SLOT_TIMEOUT].params.ticks_remaining = timeout;
+}
+
+bool typed_queue_wait(void) {
+    Coro *coro = context_get_coro();
+
+    /* The scheduler writes the unused timeout back to the sink, waiting again after a
+     * wake-up continues the original timeout. */
+    coro_yield_with_signal(CORO_SIG_WAIT);
+
+    return coro->triggered_event_sink_slot != EVENT_SINK_SLOT_TIMEOUT;
+}
+
+void typed_queue_notify(void *queue, CoroEventSourceType const source_type) {
+    Coro *coro = context_get_coro();
+
+    coro->event_source.type = source_type;
+    coro->event_source.params.subject = queue;
+    coro_yield_with_signal(CORO_SIG_NOTIFY);
+}
+
+Result typed_queue_notify_no_wait(void *queue, CoroEventSourceType const source_type,
+                                  bool const from_isr) {
+    Scheduler *scheduler = context_get_scheduler();
+    CoroEventSource const event = {.type = source_type, .params.subject = queue};
+    Result const notify_result = (from_isr)
+                                     ? scheduler_notify_from_isr(scheduler, &event)
+                                     : scheduler_notify(scheduler, &event);
+
+    if (notify_result != RES_OK) {
+        /* Critical failure to notify scheduler. */
+        return RES_NOTIFY_FAILED;
+    }
+
+    return RES_OK;
+}
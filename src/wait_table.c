@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: Copyright contributors to the poco project.
+// SPDX-License-Identifier: MIT
+/*!
+ * @file
+ * @brief Per-subject wait list implementation.
+ */
+
+#include <poco/coro_raw.h>
+#include <poco/wait_table.h>
+#include <stdint.h>
+
+static bool _is_subject_sink(CoroEventSink const *sink) {
+    return (sink->type != CORO_EVTSINK_NONE) && (sink->type != CORO_EVTSINK_DELAY);
+}
+
+static bool _is_subject_event(CoroEventSource const *event) {
+    return (event->type != CORO_EVTSRC_NOOP) && (event->type != CORO_EVTSRC_ELAPSED);
+}
+
+static ListNode *_get_bucket(WaitTable *table, void const *subject) {
+    /* Subjects are at least word aligned, drop the low bits before mixing. */
+    uintptr_t hash = (uintptr_t)subject >> 3;
+    hash ^= hash >> 7;
+    hash ^= hash >> 13;
+    return &table->buckets[hash & (WAIT_TABLE_BUCKET_COUNT - 1)];
+}
+
+void wait_table_init(WaitTable *table) {
+    for (size_t idx = 0; idx < WAIT_TABLE_BUCKET_COUNT; ++idx) {
+        list_init(&table->buckets[idx]);
+    }
+}
+
+void wait_table_add(WaitTable *table, Coro *coro) {
+    CoroEventSink const *sink = &coro->event_sinks[EVENT_SINK_SLOT_PRIMARY];
+
+    if (!_is_subject_sink(sink)) {
+        /* Nothing to wait on, only timeouts (if any) can unblock this coroutine. */
+        return;
+    }
+
+    list_push_back(_get_bucket(table, sink->params.subject), &coro->list_node);
+}
+
+void wait_table_remove(Coro *coro) {
+    if (list_node_is_linked(&coro->list_node)) {
+        list_remove(&coro->list_node);
+    }
+}
+
+size_t wait_table_notify(WaitTable *table, CoroEventSource const *event,
+                         ListNode *unblocked) {
+    if (!_is_subject_event(event)) {
+        return 0;
+    }
+
+    size_t unblocked_count = 0;
+    ListNode *bucket = _get_bucket(table, event->params.subject);
+    ListNode *node = bucket->next;
+
+    while (node != bucket) {
+        /* Fetch the next node first, as a notified coroutine leaves the list. */
+        ListNode *next_node = node->next;
+        Coro *coro = LIST_CONTAINER_OF(node, Coro, list_node);
+
+        if (coro_notify(coro, event)) {
+            list_remove(node);
+            list_push_back(unblocked, node);
+            unblocked_count++;
+        }
+
+        node = next_node;
+    }
+
+    return unblocked_count;
+}
+
+size_t wait_table_notify_all(WaitTable *table, ListNode *unblocked) {
+    size_t unblocked_count = 0;
+
+    for (size_t idx = 0; idx < WAIT_TABLE_BUCKET_COUNT; ++idx) {
+        ListNode *node = NULL;
+        while ((node = list_pop_front(&table->buckets[idx])) != NULL) {
+            Coro *coro = LIST_CONTAINER_OF(node, Coro, list_node);
+            coro_wake(coro);
+            list_push_back(unblocked, node);
+            unblocked_count++;
+        }
+    }
+
+    return unblocked_count;
+}
@@ -83,19 +83,65 @@ static void test_setting_from_isr(void **state) {
  * @brief Setting more than the allowable queued values causes a failure.
  */
 static void test_event_setting_from_isr_notify_failure(void **state) {
-    Event *event = event_create(0);
+    Event events[SCHEDULER_MAX_EXTERNAL_EVENT_COUNT + 1];
     Result isr_result = RES_OK;
 
+    // Events are only queued once per subject, each set must be on a different event
     for (size_t count = 0; count < SCHEDULER_MAX_EXTERNAL_EVENT_COUNT; ++count) {
-        isr_result = event_set_from_isr(event, 0x80);
+        event_create_static(&events[count], 0);
+        isr_result = event_set_from_isr(&events[count], 0x80);
         assert_int_equal(isr_result, RES_OK);
     }
 
     // last set should result in an error
-    isr_result = event_set_from_isr(event, 0x80);
+    event_create_static(&events[SCHEDULER_MAX_EXTERNAL_EVENT_COUNT], 0);
+    isr_result = event_set_from_isr(&events[SCHEDULER_MAX_EXTERNAL_EVENT_COUNT], 0x80);
     assert_int_equal(isr_result, RES_NOTIFY_FAILED);
 }
 
+/*!
+ * @brief Setting the same event many times from an ISR only queues one event.
+ */
+static void test_event_setting_from_isr_coalesced(void **state) {
+    Event *event = event_create(0);
+
+    for (size_t count = 0; count < (SCHEDULER_MAX_EXTERNAL_EVENT_COUNT * 4); ++count) {
+        assert_int_equal(event_set_from_isr(event, 0x1 << (count % 8)), RES_OK);
+    }
+
+    Flags const result = event_get(event, 0xFF, 0xFF, true, PLATFORM_TICKS_FOREVER);
+    assert_int_equal(result, 0xFF);
+}
+
+static void _wait_for_bit(void *context) {
+    Event *event = (Event *)context;
+    event_get(event, 0x1, 0x1, true, PLATFORM_TICKS_FOREVER);
+}
+
+/*!
+ * @brief Coroutines waiting on an event that was dropped, as the scheduler could not
+ *        hold any more external events, are still woken.
+ */
+static void test_event_setting_from_isr_overflow_recovery(void **state) {
+    Event *event = event_create(0);
+    Event other_events[SCHEDULER_MAX_EXTERNAL_EVENT_COUNT];
+    Coro *waiter = coro_create(_wait_for_bit, event, DEFAULT_STACK_SIZE);
+
+    round_robin_scheduler_add_coro((RoundRobinScheduler *)context_get_scheduler(),
+                                   waiter);
+    coro_yield();
+
+    for (size_t count = 0; count < SCHEDULER_MAX_EXTERNAL_EVENT_COUNT; ++count) {
+        event_create_static(&other_events[count], 0);
+        assert_int_equal(event_set_from_isr(&other_events[count], 0x1), RES_OK);
+    }
+    assert_int_equal(event_set_from_isr(event, 0x1), RES_NOTIFY_FAILED);
+
+    coro_join(waiter);
+
+    assert_int_equal(event->flags, 0);
+}
+
 int main(void) {
     const struct CMUnitTest tests[] = {
         cmocka_coro_unit_test(test_event_create_and_free),
@@ -103,6 +149,8 @@ int main(void) {
         cmocka_coro_unit_test(test_event_wait_on_all_bit),
         cmocka_coro_unit_test(test_setting_from_isr),
         cmocka_coro_unit_test(test_event_setting_from_isr_notify_failure),
+        cmocka_coro_unit_test(test_event_setting_from_isr_coalesced),
+        cmocka_coro_unit_test(test_event_setting_from_isr_overflow_recovery),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
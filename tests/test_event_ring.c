@@ -0,0 +1,231 @@
+/*!
+ * @file
+ * @brief Tests event ring implementation.
+ */
+
+#include <poco/event_ring.h>
+
+#ifdef POCO_WITH_THREADS
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// cmocka requires these dependencies
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+// cmocka also needs to be the last included
+#include <cmocka.h>
+
+#define SLOT_COUNT (8)
+
+static int subjects[SLOT_COUNT * 4];
+
+static CoroEventSource make_event(size_t const idx) {
+    CoroEventSource const event = {.type = CORO_EVTSRC_QUEUE_PUT,
+                                   .params.subject = &subjects[idx]};
+    return event;
+}
+
+/*!
+ * @brief Slot counts must be a power of 2.
+ */
+static void test_event_ring_invalid_slot_count(void **state) {
+    EventRing ring;
+    EventRingSlot slots[SLOT_COUNT];
+
+    assert_null(event_ring_create_static(&ring, slots, 0));
+    assert_null(event_ring_create_static(&ring, slots, 6));
+    assert_non_null(event_ring_create_static(&ring, slots, SLOT_COUNT));
+}
+
+/*!
+ * @brief Events are taken in the order they are placed, across many laps of the ring.
+ */
+static void test_event_ring_fifo_order(void **state) {
+    EventRing ring;
+    EventRingSlot slots[SLOT_COUNT];
+    CoroEventSource event;
+
+    event_ring_create_static(&ring, slots, SLOT_COUNT);
+    assert_true(event_ring_is_empty(&ring));
+    assert_int_equal(event_ring_get(&ring, &event), RES_QUEUE_EMPTY);
+
+    for (size_t lap = 0; lap < 4; ++lap) {
+        for (size_t idx = 0; idx < SLOT_COUNT - 1; ++idx) {
+            CoroEventSource const placed = make_event(lap * SLOT_COUNT + idx);
+            assert_int_equal(event_ring_put(&ring, &placed), RES_OK);
+        }
+        for (size_t idx = 0; idx < SLOT_COUNT - 1; ++idx) {
+            assert_false(event_ring_is_empty(&ring));
+            assert_int_equal(event_ring_get(&ring, &event), RES_OK);
+            assert_ptr_equal(event.params.subject, &subjects[lap * SLOT_COUNT + idx]);
+        }
+        assert_true(event_ring_is_empty(&ring));
+    }
+
+    assert_int_equal(event_ring_overflow_count(&ring), 0);
+    assert_false(event_ring_check_overflow(&ring));
+}
+
+/*!
+ * @brief Events placed in a full ring are dropped and counted, and the ring keeps
+ * working once space is available.
+ */
+static void test_event_ring_overflow(void **state) {
+    EventRing ring;
+    EventRingSlot slots[SLOT_COUNT];
+    CoroEventSource event;
+
+    event_ring_create_static(&ring, slots, SLOT_COUNT);
+
+    for (size_t idx = 0; idx < SLOT_COUNT + 2; ++idx) {
+        event = make_event(idx);
+        assert_int_equal(event_ring_put(&ring, &event),
+                         (idx < SLOT_COUNT) ? RES_OK : RES_QUEUE_FULL);
+    }
+
+    assert_int_equal(event_ring_overflow_count(&ring), 2);
+    assert_true(event_ring_check_overflow(&ring));
+    assert_false(event_ring_check_overflow(&ring));
+
+    assert_int_equal(event_ring_get(&ring, &event), RES_OK);
+    event = make_event(SLOT_COUNT);
+    assert_int_equal(event_ring_put(&ring, &event), RES_OK);
+    assert_int_equal(event_ring_overflow_count(&ring), 2);
+}
+
+/*!
+ * @brief Events with the same type and subject as a waiting event only use one slot.
+ */
+static void test_event_ring_coalesces_duplicates(void **state) {
+    EventRing ring;
+    EventRingSlot slots[SLOT_COUNT];
+    CoroEventSource event = make_event(0);
+    CoroEventSource other_type = make_event(0);
+    other_type.type = CORO_EVTSRC_QUEUE_GET;
+
+    event_ring_create_static(&ring, slots, SLOT_COUNT);
+
+    for (size_t idx = 0; idx < SLOT_COUNT * 4; ++idx) {
+        assert_int_equal(event_ring_put(&ring, &event), RES_OK);
+        assert_int_equal(event_ring_put(&ring, &other_type), RES_OK);
+    }
+
+    assert_int_equal(event_ring_get(&ring, &event), RES_OK);
+    assert_int_equal(event.type, CORO_EVTSRC_QUEUE_PUT);
+    assert_int_equal(event_ring_get(&ring, &event), RES_OK);
+    assert_int_equal(event.type, CORO_EVTSRC_QUEUE_GET);
+    assert_true(event_ring_is_empty(&ring));
+    assert_int_equal(event_ring_overflow_count(&ring), 0);
+
+    /* Once read, the same event can be placed again. */
+    assert_int_equal(event_ring_put(&ring, &event), RES_OK);
+    assert_false(event_ring_is_empty(&ring));
+}
+
+/*!
+ * @brief Elapsed events are merged into a single event, holding the sum of their ticks.
+ */
+static void test_event_ring_merges_elapsed(void **state) {
+    EventRing ring;
+    EventRingSlot slots[SLOT_COUNT];
+    CoroEventSource event = {.type = CORO_EVTSRC_ELAPSED};
+
+    event_ring_create_static(&ring, slots, SLOT_COUNT);
+
+    for (PlatformTick ticks = 1; ticks <= (SLOT_COUNT * 4); ++ticks) {
+        event.params.elapsed_ticks = ticks;
+        assert_int_equal(event_ring_put(&ring, &event), RES_OK);
+    }
+
+    assert_false(event_ring_is_empty(&ring));
+    assert_int_equal(event_ring_get(&ring, &event), RES_OK);
+    assert_int_equal(event.type, CORO_EVTSRC_ELAPSED);
+    assert_int_equal(event.params.elapsed_ticks,
+                     (SLOT_COUNT * 4) * ((SLOT_COUNT * 4) + 1) / 2);
+    assert_true(event_ring_is_empty(&ring));
+}
+
+#ifdef POCO_WITH_THREADS
+
+#define PRODUCER_COUNT (4)
+#define EVENTS_PER_PRODUCER (20000)
+
+typedef struct producer {
+    pthread_t thread;
+    EventRing *ring;
+    uintptr_t index;
+} Producer;
+
+/* Events carry their producer and sequence number in place of a subject. */
+static void *produce(void *context) {
+    Producer const *producer = context;
+    for (uintptr_t sequence = 0; sequence < EVENTS_PER_PRODUCER; ++sequence) {
+        CoroEventSource const event = {
+            .type = CORO_EVTSRC_QUEUE_PUT,
+            .params.subject = (void *)((sequence * PRODUCER_COUNT) + producer->index),
+        };
+        while (event_ring_put(producer->ring, &event) != RES_OK) {
+            /* Full, let the consumer run. */
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/*!
+ * @brief Concurrent producers never lose nor reorder their own events.
+ */
+static void test_event_ring_concurrent_producers(void **state) {
+    EventRing ring;
+    EventRingSlot slots[SLOT_COUNT];
+    Producer producers[PRODUCER_COUNT];
+    uintptr_t next_sequence[PRODUCER_COUNT] = {0};
+
+    event_ring_create_static(&ring, slots, SLOT_COUNT);
+
+    for (uintptr_t idx = 0; idx < PRODUCER_COUNT; ++idx) {
+        producers[idx].ring = &ring;
+        producers[idx].index = idx;
+        assert_int_equal(
+            pthread_create(&producers[idx].thread, NULL, produce, &producers[idx]), 0);
+    }
+
+    for (size_t received = 0; received < PRODUCER_COUNT * EVENTS_PER_PRODUCER;) {
+        CoroEventSource event;
+        if (event_ring_get(&ring, &event) == RES_OK) {
+            uintptr_t const value = (uintptr_t)event.params.subject;
+            uintptr_t const index = value % PRODUCER_COUNT;
+            assert_int_equal(value / PRODUCER_COUNT, next_sequence[index]);
+            next_sequence[index]++;
+            received++;
+        } else {
+            sched_yield();
+        }
+    }
+
+    for (size_t idx = 0; idx < PRODUCER_COUNT; ++idx) {
+        pthread_join(producers[idx].thread, NULL);
+    }
+
+    assert_true(event_ring_is_empty(&ring));
+}
+
+#endif
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_event_ring_invalid_slot_count),
+        cmocka_unit_test(test_event_ring_fifo_order),
+        cmocka_unit_test(test_event_ring_overflow),
+        cmocka_unit_test(test_event_ring_coalesces_duplicates),
+        cmocka_unit_test(test_event_ring_merges_elapsed),
+#ifdef POCO_WITH_THREADS
+        cmocka_unit_test(test_event_ring_concurrent_producers),
+#endif
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
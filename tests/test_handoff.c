@@ -0,0 +1,288 @@
+/*!
+ * @file
+ * @brief Tests handing off to woken coroutines, and yielding to a coroutine.
+ */
+
+#include <poco/poco.h>
+
+// cmocka requires these dependencies
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+// cmocka also needs to be the last included
+#include <cmocka.h>
+
+#define FILLER_COUNT (32)
+#define ROUND_COUNT (8)
+#define REPEAT_COUNT (2 * SCHEDULER_HANDOFF_LIMIT)
+#define FEW_FILLER_COUNT (4)
+
+typedef struct pipeline {
+    Queue *requests;
+    Queue *responses;
+    size_t filler_runs; /**< Number of times any filler ran. */
+    size_t total_delay; /**< Filler runs between requests and their handling. */
+    size_t max_delay;   /**< Most filler runs between a yield and the target running. */
+    size_t kept_turns;  /**< Puts waking nobody, resumed before the fillers ran. */
+    size_t released_at; /**< Filler runs when the semaphore was last released. */
+    size_t handed_off;  /**< Acquires resumed before any filler ran. */
+    Semaphore *signal;
+    bool yielded; /**< The repeated yields to the target are done. */
+    bool done;
+    bool pending; /**< A yield to the target is pending. */
+    Coro *target;
+} Pipeline;
+
+static void filler_task(void *context) {
+    Pipeline *pipeline = context;
+    while (!pipeline->done) {
+        pipeline->filler_runs++;
+        coro_yield();
+    }
+}
+
+static void client_task(void *context) {
+    Pipeline *pipeline = context;
+    for (size_t round = 0; round < ROUND_COUNT; ++round) {
+        size_t sent = pipeline->filler_runs;
+        size_t received = 0;
+        queue_put(pipeline->requests, &sent, PLATFORM_TICKS_FOREVER);
+        queue_get(pipeline->responses, &received, PLATFORM_TICKS_FOREVER);
+    }
+    pipeline->done = true;
+}
+
+static void server_task(void *context) {
+    Pipeline *pipeline = context;
+    for (size_t round = 0; round < ROUND_COUNT; ++round) {
+        size_t sent = 0;
+        queue_get(pipeline->requests, &sent, PLATFORM_TICKS_FOREVER);
+        pipeline->total_delay += pipeline->filler_runs - sent;
+        queue_put(pipeline->responses, &sent, PLATFORM_TICKS_FOREVER);
+    }
+}
+
+static void lone_producer_task(void *context) {
+    Pipeline *pipeline = context;
+    for (size_t round = 0; round < ROUND_COUNT; ++round) {
+        size_t const seen = pipeline->filler_runs;
+        queue_put(pipeline->requests, &round, PLATFORM_TICKS_FOREVER);
+        if (pipeline->filler_runs - seen < FILLER_COUNT) {
+            pipeline->kept_turns++;
+        }
+    }
+    pipeline->done = true;
+}
+
+static void repeated_yielding_task(void *context) {
+    Pipeline *pipeline = context;
+    for (size_t idx = 0; idx < REPEAT_COUNT; ++idx) {
+        coro_yield_to(pipeline->target);
+    }
+    pipeline->yielded = true;
+}
+
+static void releasing_task(void *context) {
+    Pipeline *pipeline = context;
+    while (!pipeline->yielded) {
+        coro_yield();
+    }
+    for (size_t round = 0; round < ROUND_COUNT; ++round) {
+        pipeline->released_at = pipeline->filler_runs;
+        semaphore_release(pipeline->signal);
+        coro_yield();
+    }
+    pipeline->done = true;
+}
+
+static void acquiring_task(void *context) {
+    Pipeline *pipeline = context;
+    for (size_t round = 0; round < ROUND_COUNT; ++round) {
+        semaphore_acquire(pipeline->signal, PLATFORM_TICKS_FOREVER);
+        if (pipeline->filler_runs == pipeline->released_at) {
+            pipeline->handed_off++;
+        }
+    }
+}
+
+static void yielding_task(void *context) {
+    Pipeline *pipeline = context;
+    for (size_t round = 0; round < ROUND_COUNT; ++round) {
+        pipeline->filler_runs = 0;
+        pipeline->pending = true;
+        coro_yield_to(pipeline->target);
+    }
+    pipeline->done = true;
+}
+
+static void target_task(void *context) {
+    Pipeline *pipeline = context;
+    while (!pipeline->done) {
+        if (pipeline->pending && pipeline->filler_runs > pipeline->max_delay) {
+            pipeline->max_delay = pipeline->filler_runs;
+        }
+        pipeline->pending = false;
+        coro_yield();
+    }
+}
+
+/*!
+ * @brief Runs a request and response pipeline next to many busy coroutines.
+ */
+static size_t run_pipeline(bool handoff) {
+    Pipeline pipeline = {
+        .requests = queue_create(1, sizeof(size_t)),
+        .responses = queue_create(1, sizeof(size_t)),
+    };
+    Coro *coros[FILLER_COUNT + 2];
+
+    /* The server runs first, to wait on requests before the client sends any. */
+    coros[0] = coro_create(server_task, &pipeline, DEFAULT_STACK_SIZE);
+    for (size_t idx = 1; idx <= FILLER_COUNT; ++idx) {
+        coros[idx] = coro_create(filler_task, &pipeline, DEFAULT_STACK_SIZE);
+    }
+    coros[FILLER_COUNT + 1] = coro_create(client_task, &pipeline, DEFAULT_STACK_SIZE);
+
+    RoundRobinScheduler *scheduler =
+        (RoundRobinScheduler *)round_robin_scheduler_create(coros, FILLER_COUNT + 2);
+    round_robin_scheduler_set_handoff(scheduler, handoff);
+    scheduler_run((Scheduler *)scheduler);
+
+    round_round_robin_scheduler_free(scheduler);
+    for (size_t idx = 0; idx < FILLER_COUNT + 2; ++idx) {
+        coro_free(coros[idx]);
+    }
+    queue_free(pipeline.requests);
+    queue_free(pipeline.responses);
+    return pipeline.total_delay;
+}
+
+/*!
+ * @brief With handoff, requests are mostly handled before any other coroutine runs.
+ */
+static void test_handoff_pipeline(void **state) {
+    size_t const handoff_delay = run_pipeline(true);
+
+    /* Every request waits for the others, a sweep after the request and one after
+     * taking it. */
+    assert_true(run_pipeline(false) >= 2 * ROUND_COUNT * FILLER_COUNT);
+
+    /* The request is taken before any other coroutine runs. Taking it wakes nobody, so
+     * the server gives way for one sweep. */
+    assert_in_range(handoff_delay, 0, ROUND_COUNT * FILLER_COUNT);
+}
+
+/*!
+ * @brief With handoff, a coroutine notifying an event nobody waits on does not keep its
+ * turn.
+ */
+static void test_handoff_no_waiter(void **state) {
+    Pipeline pipeline = {.requests = queue_create(ROUND_COUNT, sizeof(size_t))};
+    Coro *coros[FILLER_COUNT + 1];
+
+    coros[0] = coro_create(lone_producer_task, &pipeline, DEFAULT_STACK_SIZE);
+    for (size_t idx = 1; idx <= FILLER_COUNT; ++idx) {
+        coros[idx] = coro_create(filler_task, &pipeline, DEFAULT_STACK_SIZE);
+    }
+
+    RoundRobinScheduler *scheduler =
+        (RoundRobinScheduler *)round_robin_scheduler_create(coros, FILLER_COUNT + 1);
+    round_robin_scheduler_set_handoff(scheduler, true);
+    scheduler_run((Scheduler *)scheduler);
+
+    assert_int_equal(pipeline.kept_turns, 0);
+
+    round_round_robin_scheduler_free(scheduler);
+    for (size_t idx = 0; idx <= FILLER_COUNT; ++idx) {
+        coro_free(coros[idx]);
+    }
+    queue_free(pipeline.requests);
+}
+
+/*!
+ * @brief Runs a coroutine yielding to another next to many busy coroutines.
+ */
+static size_t run_yield_to(bool priority) {
+    Pipeline pipeline = {0};
+    Coro *coros[FILLER_COUNT + 2];
+    uint8_t priorities[FILLER_COUNT + 2] = {0};
+
+    coros[0] = coro_create(yielding_task, &pipeline, DEFAULT_STACK_SIZE);
+    for (size_t idx = 1; idx <= FILLER_COUNT; ++idx) {
+        coros[idx] = coro_create(filler_task, &pipeline, DEFAULT_STACK_SIZE);
+    }
+    coros[FILLER_COUNT + 1] = coro_create(target_task, &pipeline, DEFAULT_STACK_SIZE);
+    pipeline.target = coros[FILLER_COUNT + 1];
+
+    if (priority) {
+        Scheduler *scheduler =
+            priority_scheduler_create(coros, priorities, FILLER_COUNT + 2);
+        scheduler_run(scheduler);
+        priority_scheduler_free((PriorityScheduler *)scheduler);
+    } else {
+        Scheduler *scheduler = round_robin_scheduler_create(coros, FILLER_COUNT + 2);
+        scheduler_run(scheduler);
+        round_round_robin_scheduler_free((RoundRobinScheduler *)scheduler);
+    }
+
+    for (size_t idx = 0; idx < FILLER_COUNT + 2; ++idx) {
+        coro_free(coros[idx]);
+    }
+    return pipeline.max_delay;
+}
+
+/*!
+ * @brief Yielding to the same coroutine again, before it ran, counts a single handoff.
+ *
+ * A higher priority coroutine yields to a lower priority one many times, moving it to
+ * the front of its ready list each time. The lower priority coroutines then run a
+ * fresh handoff streak, and every wake-up is handed off.
+ */
+static void test_handoff_repeated_yield_to(void **state) {
+    Pipeline pipeline = {.signal = semaphore_create_binary()};
+    Coro *coros[FEW_FILLER_COUNT + 3];
+    uint8_t priorities[FEW_FILLER_COUNT + 3] = {0};
+
+    assert_int_equal(semaphore_acquire_no_wait(pipeline.signal), RES_OK);
+    coros[0] = coro_create(repeated_yielding_task, &pipeline, DEFAULT_STACK_SIZE);
+    priorities[0] = 1;
+    coros[1] = coro_create(acquiring_task, &pipeline, DEFAULT_STACK_SIZE);
+    coros[2] = coro_create(releasing_task, &pipeline, DEFAULT_STACK_SIZE);
+    for (size_t idx = 3; idx < FEW_FILLER_COUNT + 3; ++idx) {
+        coros[idx] = coro_create(filler_task, &pipeline, DEFAULT_STACK_SIZE);
+    }
+    pipeline.target = coros[FEW_FILLER_COUNT + 2];
+
+    Scheduler *scheduler =
+        priority_scheduler_create(coros, priorities, FEW_FILLER_COUNT + 3);
+    priority_scheduler_set_handoff((PriorityScheduler *)scheduler, true);
+    scheduler_run(scheduler);
+
+    assert_int_equal(pipeline.handed_off, ROUND_COUNT);
+
+    priority_scheduler_free((PriorityScheduler *)scheduler);
+    for (size_t idx = 0; idx < FEW_FILLER_COUNT + 3; ++idx) {
+        coro_free(coros[idx]);
+    }
+    semaphore_free(pipeline.signal);
+}
+
+/*!
+ * @brief Yielding to a coroutine resumes it next, for both list based schedulers.
+ */
+static void test_handoff_yield_to(void **state) {
+    assert_int_equal(run_yield_to(false), 0);
+    assert_int_equal(run_yield_to(true), 0);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_handoff_pipeline),
+        cmocka_unit_test(test_handoff_no_waiter),
+        cmocka_unit_test(test_handoff_yield_to),
+        cmocka_unit_test(test_handoff_repeated_yield_to),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
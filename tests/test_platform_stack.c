@@ -0,0 +1,144 @@
+/*!
+ * @file
+ * @brief Tests unix stack allocation.
+ */
+
+#include "cmocka_coro_helper.h"
+#include <poco/poco.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// cmocka requires these dependencies
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+// cmocka also needs to be the last included
+#include <cmocka.h>
+
+#define LARGE_STACK_BYTES (1024 * 1024)
+#define LARGE_STACK (LARGE_STACK_BYTES / sizeof(PlatformStackElement))
+#define SMALL_STACK (1024 / sizeof(PlatformStackElement))
+
+/** Stack used by the deep task, well below the large stack size. */
+#define DEEP_FRAME_BYTES (256 * 1024)
+
+/*!
+ * @brief Stacks are zero filled, and large stacks start on a page boundary.
+ */
+static void test_platform_stack_zero_filled(void **state) {
+    size_t const page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size_t const counts[] = {SMALL_STACK, LARGE_STACK};
+
+    for (size_t idx = 0; idx < 2; ++idx) {
+        PlatformStackElement *stack = platform_stack_alloc(counts[idx]);
+        assert_non_null(stack);
+        assert_int_equal(stack[0], 0);
+        assert_int_equal(stack[counts[idx] - 1], 0);
+        platform_stack_free(stack, counts[idx]);
+    }
+
+    PlatformStackElement *stack = platform_stack_alloc(LARGE_STACK);
+    assert_int_equal((uintptr_t)stack % page_size, 0);
+    platform_stack_free(stack, LARGE_STACK);
+}
+
+/*!
+ * @brief Writing below a large stack faults on its guard page.
+ */
+static void test_platform_stack_guard_page(void **state) {
+    PlatformStackElement *stack = platform_stack_alloc(LARGE_STACK);
+    assert_non_null(stack);
+
+    pid_t const child = fork();
+    assert_true(child >= 0);
+    if (child == 0) {
+        ((PlatformStackElement volatile *)stack)[-1] = 1;
+        _exit(0);
+    }
+
+    int status = 0;
+    assert_int_equal(waitpid(child, &status, 0), child);
+    assert_true(WIFSIGNALED(status));
+    assert_true((WTERMSIG(status) == SIGSEGV) || (WTERMSIG(status) == SIGBUS));
+
+    platform_stack_free(stack, LARGE_STACK);
+}
+
+static void deep_task(void *context) {
+    uint8_t volatile frame[DEEP_FRAME_BYTES];
+    size_t *sum = context;
+
+    for (size_t idx = 0; idx < DEEP_FRAME_BYTES; ++idx) {
+        frame[idx] = (uint8_t)idx;
+    }
+    coro_yield();
+    for (size_t idx = 0; idx < DEEP_FRAME_BYTES; ++idx) {
+        *sum += frame[idx];
+    }
+}
+
+/*!
+ * @brief Coroutines on oversized stacks run, and keep their frames across yields.
+ */
+static void test_platform_stack_oversized_coroutine(void **state) {
+    RoundRobinScheduler *scheduler = (RoundRobinScheduler *)context_get_scheduler();
+    size_t sum = 0;
+    size_t expected = 0;
+
+    for (size_t idx = 0; idx < DEEP_FRAME_BYTES; ++idx) {
+        expected += (uint8_t)idx;
+    }
+
+    Coro *coro = coro_create(deep_task, &sum, LARGE_STACK);
+    assert_non_null(coro);
+    assert_int_equal(round_robin_scheduler_add_coro(scheduler, coro), RES_OK);
+
+    coro_join(coro);
+    assert_int_equal(sum, expected);
+
+    round_robin_scheduler_remove_coro(scheduler, coro);
+    coro_free(coro);
+}
+
+#ifdef __linux__
+/*!
+ * @brief Only the pages touched by a coroutine are resident.
+ */
+static void test_platform_stack_lazy_commit(void **state) {
+    size_t const page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size_t const page_count = LARGE_STACK_BYTES / page_size;
+    unsigned char residency[LARGE_STACK_BYTES / 4096];
+    size_t resident = 0;
+
+    assert_true(page_count <= sizeof(residency));
+
+    Coro *coro = coro_create(deep_task, NULL, LARGE_STACK);
+    assert_non_null(coro);
+
+    assert_int_equal(mincore(coro->stack, LARGE_STACK_BYTES, residency), 0);
+    for (size_t idx = 0; idx < page_count; ++idx) {
+        resident += residency[idx] & 1;
+    }
+
+    /* Only the end marker, and the initial frame next to it, were written. */
+    assert_in_range(resident, 1, 2);
+
+    coro_free(coro);
+}
+#endif
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_platform_stack_zero_filled),
+        cmocka_unit_test(test_platform_stack_guard_page),
+        cmocka_coro_unit_test(test_platform_stack_oversized_coroutine),
+#ifdef __linux__
+        cmocka_unit_test(test_platform_stack_lazy_commit),
+#endif
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
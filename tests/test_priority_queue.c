@@ -0,0 +1,158 @@
+/*!
+ * @file
+ * @brief Tests the priority queue.
+ */
+
+#include "cmocka_coro_helper.h"
+#include <poco/poco.h>
+#include <poco/priority_queue.h>
+
+// cmocka requires these dependencies
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+// cmocka also needs to be the last included
+#include <cmocka.h>
+
+#define SLOT_COUNT (16)
+#define ITEM_COUNT (64)
+
+/** Test item for queue testing. */
+typedef struct dummy_item {
+    uint32_t a;
+    uint8_t b;
+    uint32_t c;
+} dummy_item_t;
+
+static void producer_coro(void *context) {
+    PriorityQueue *queue = context;
+    for (uint32_t idx = 0; idx < ITEM_COUNT; ++idx) {
+        dummy_item_t const item = {.a = idx, .b = (uint8_t)idx, .c = 2 * idx};
+        assert_int_equal(RES_OK,
+                         priority_queue_put(queue, &item, 0, PLATFORM_TICKS_FOREVER));
+    }
+}
+
+/*!
+ * @brief Tests items are got highest priority first, and in put order within a
+ * priority, while slots are reused.
+ */
+static void test_priority_queue_order(void **context) {
+    PriorityQueue queue;
+    PriorityQueueNode nodes[SLOT_COUNT];
+    dummy_item_t buffer[SLOT_COUNT];
+    dummy_item_t item = {0};
+    uint32_t priority = 0;
+
+    priority_queue_create_static(&queue, SLOT_COUNT, sizeof(dummy_item_t),
+                                 (uint8_t *)buffer, nodes);
+    assert_true(priority_queue_is_empty(&queue));
+    assert_int_equal(RES_QUEUE_EMPTY, priority_queue_get_no_wait(&queue, &item, NULL));
+
+    for (uint32_t round = 0; round < 4; ++round) {
+        /* Priorities 0 to 3, shuffled, four items each. */
+        for (uint32_t idx = 0; idx < SLOT_COUNT; ++idx) {
+            dummy_item_t const put = {
+                .a = idx, .b = (uint8_t)round, .c = (idx * 7) % 4};
+            assert_int_equal(RES_OK, priority_queue_put_no_wait(&queue, &put, put.c));
+        }
+        assert_true(priority_queue_is_full(&queue));
+        assert_int_equal(RES_QUEUE_FULL, priority_queue_put_no_wait(&queue, &item, 9));
+
+        uint32_t last_priority = UINT32_MAX;
+        uint32_t last_a = 0;
+        for (uint32_t idx = 0; idx < SLOT_COUNT; ++idx) {
+            assert_int_equal(RES_OK,
+                             priority_queue_get_no_wait(&queue, &item, &priority));
+            assert_int_equal(round, item.b);
+            assert_int_equal(item.c, priority);
+            assert_true(priority <= last_priority);
+            if (priority == last_priority) {
+                assert_true(item.a > last_a);
+            }
+            last_priority = priority;
+            last_a = item.a;
+        }
+        assert_int_equal(0, priority_queue_item_count(&queue));
+    }
+}
+
+/*!
+ * @brief Tests a later urgent item overtakes the queued ones.
+ */
+static void test_priority_queue_urgent(void **context) {
+    PriorityQueue *queue = priority_queue_create(SLOT_COUNT, sizeof(uint32_t));
+    uint32_t item = 0;
+
+    assert_non_null(queue);
+    for (uint32_t idx = 0; idx < 8; ++idx) {
+        assert_int_equal(RES_OK, priority_queue_put_no_wait(queue, &idx, 1));
+    }
+    item = 100;
+    assert_int_equal(RES_OK, priority_queue_put_no_wait(queue, &item, 5));
+
+    assert_int_equal(RES_OK, priority_queue_get_no_wait(queue, &item, NULL));
+    assert_int_equal(100, item);
+    for (uint32_t idx = 0; idx < 8; ++idx) {
+        assert_int_equal(RES_OK, priority_queue_get_no_wait(queue, &item, NULL));
+        assert_int_equal(idx, item);
+    }
+
+    priority_queue_free(queue);
+}
+
+/*!
+ * @brief Tests a producer blocks on a full queue until the consumer makes room.
+ */
+static void test_priority_queue_blocking(void **context) {
+    PriorityQueue *queue = priority_queue_create(4, sizeof(dummy_item_t));
+    dummy_item_t item = {0};
+
+    Coro *coro = coro_create(producer_coro, queue, DEFAULT_STACK_SIZE);
+    round_robin_scheduler_add_coro((RoundRobinScheduler *)context_get_scheduler(),
+                                   coro);
+
+    for (uint32_t idx = 0; idx < ITEM_COUNT; ++idx) {
+        assert_int_equal(
+            RES_OK, priority_queue_get(queue, &item, NULL, PLATFORM_TICKS_FOREVER));
+        assert_int_equal(idx, item.a);
+        assert_int_equal(2 * idx, item.c);
+    }
+    coro_join(coro);
+    assert_true(priority_queue_is_empty(queue));
+
+    round_robin_scheduler_remove_coro((RoundRobinScheduler *)context_get_scheduler(),
+                                      coro);
+    coro_free(coro);
+    priority_queue_free(queue);
+}
+
+/*!
+ * @brief Tests a get on an empty queue waits at least the timeout before giving up.
+ */
+static void test_priority_queue_get_timeout(void **context) {
+    PriorityQueue *queue = priority_queue_create(4, sizeof(dummy_item_t));
+    dummy_item_t item = {0};
+    PlatformTick const timeout = 20 * platform_get_ticks_per_ms();
+
+    PlatformTick const start_ticks = platform_get_monotonic_ticks();
+    Result const result = priority_queue_get(queue, &item, NULL, timeout);
+    PlatformTick const elapsed_ticks = platform_get_monotonic_ticks() - start_ticks;
+
+    assert_int_equal(RES_TIMEOUT, result);
+    assert_true(elapsed_ticks >= timeout);
+
+    priority_queue_free(queue);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_coro_unit_test(test_priority_queue_order),
+        cmocka_coro_unit_test(test_priority_queue_urgent),
+        cmocka_coro_unit_test(test_priority_queue_blocking),
+        cmocka_coro_unit_test(test_priority_queue_get_timeout),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -115,12 +115,216 @@ static void test_queue_put_and_get_reverse_order(void **context) {
     assert_int_equal(expected_item, actual_item);
 }
 
+/*!
+ * @brief Tests a get on an empty queue waits at least the timeout before giving up.
+ */
+static void test_queue_get_timeout(void **context) {
+    int item = 0;
+    PlatformTick const timeout = 20 * platform_get_ticks_per_ms();
+    Queue *queue = queue_create(1, sizeof(int));
+
+    PlatformTick const start_ticks = platform_get_monotonic_ticks();
+    Result const result = queue_get(queue, &item, timeout);
+    PlatformTick const elapsed_ticks = platform_get_monotonic_ticks() - start_ticks;
+
+    assert_int_equal(RES_TIMEOUT, result);
+    assert_true(elapsed_ticks >= timeout);
+}
+
+/*!
+ * @brief Tests items are built in a reserved slot, and only queued on commit.
+ */
+static void test_queue_reserve_and_commit(void **context) {
+    Queue *queue = queue_create(2, sizeof(dummy_item_t));
+    dummy_item_t const item = {.a = 1, .b = 2, .c = 12};
+    dummy_item_t actual_item = {0};
+    void *slot = NULL;
+
+    assert_int_equal(RES_QUEUE_NOT_RESERVED, queue_put_commit(queue));
+
+    assert_int_equal(RES_OK, queue_put_reserve(queue, &slot, PLATFORM_TICKS_FOREVER));
+    assert_ptr_equal(slot, queue->item_buffer);
+    memcpy(slot, &item, sizeof(item));
+
+    /* Not visible to consumers, and not free to other producers. */
+    assert_int_equal(RES_QUEUE_EMPTY, queue_get_no_wait(queue, &actual_item));
+    assert_int_equal(RES_QUEUE_FULL, queue_put_no_wait(queue, &item));
+    assert_int_equal(RES_QUEUE_FULL, queue_put_reserve_no_wait(queue, &slot));
+
+    assert_int_equal(RES_OK, queue_put_commit(queue));
+    assert_int_equal(RES_OK, queue_get(queue, &actual_item, PLATFORM_TICKS_FOREVER));
+    assert_memory_equal(&item, &actual_item, sizeof(item));
+
+    queue_free(queue);
+}
+
+/*!
+ * @brief Tests items are used in place, and only removed on release.
+ */
+static void test_queue_peek_and_release(void **context) {
+    Queue *queue = queue_create(2, sizeof(int));
+    int const items[] = {55, 66};
+    int actual_item = 0;
+    void *item = NULL;
+
+    queue_put(queue, &items[0], PLATFORM_TICKS_FOREVER);
+    queue_put(queue, &items[1], PLATFORM_TICKS_FOREVER);
+
+    assert_int_equal(RES_OK, queue_get_peek(queue, &item, PLATFORM_TICKS_FOREVER));
+    assert_int_equal(items[0], *(int *)item);
+
+    /* Held by the peek, not available to other consumers. */
+    assert_int_equal(RES_QUEUE_EMPTY, queue_get_no_wait(queue, &actual_item));
+    assert_int_equal(RES_QUEUE_EMPTY, queue_get_peek_no_wait(queue, &item));
+    assert_int_equal(2, queue_item_count(queue));
+
+    assert_int_equal(RES_OK, queue_get_release(queue));
+    assert_int_equal(RES_QUEUE_NOT_RESERVED, queue_get_release(queue));
+    assert_int_equal(RES_OK, queue_get(queue, &actual_item, PLATFORM_TICKS_FOREVER));
+    assert_int_equal(items[1], actual_item);
+
+    queue_free(queue);
+}
+
+typedef struct blocked_put {
+    Queue *queue;
+    Result result;
+} BlockedPut;
+
+static void blocked_put_coro(void *context) {
+    BlockedPut *blocked = context;
+    int const item = 66;
+    PlatformTick const timeout = 100 * platform_get_ticks_per_ms();
+    blocked->result = queue_put(blocked->queue, &item, timeout);
+}
+
+/*!
+ * @brief Tests a producer blocked behind a reserved slot is woken by the commit.
+ */
+static void test_queue_put_waits_for_commit(void **context) {
+    BlockedPut blocked = {.queue = queue_create(2, sizeof(int)), .result = RES_TIMEOUT};
+    int actual_item = 0;
+    void *slot = NULL;
+
+    assert_int_equal(RES_OK, queue_put_reserve_no_wait(blocked.queue, &slot));
+
+    Coro *put_coro = coro_create(blocked_put_coro, &blocked, DEFAULT_STACK_SIZE);
+    round_robin_scheduler_add_coro((RoundRobinScheduler *)context_get_scheduler(),
+                                   put_coro);
+    coro_yield();
+
+    *(int *)slot = 55;
+    assert_int_equal(RES_OK, queue_put_commit(blocked.queue));
+    coro_join(put_coro);
+    assert_int_equal(RES_OK, blocked.result);
+
+    queue_get(blocked.queue, &actual_item, PLATFORM_TICKS_FOREVER);
+    assert_int_equal(55, actual_item);
+    queue_get(blocked.queue, &actual_item, PLATFORM_TICKS_FOREVER);
+    assert_int_equal(66, actual_item);
+
+    round_robin_scheduler_remove_coro((RoundRobinScheduler *)context_get_scheduler(),
+                                      put_coro);
+    coro_free(put_coro);
+    queue_free(blocked.queue);
+}
+
+/*!
+ * @brief Tests batches are copied around the end of the buffer, in order.
+ */
+static void test_queue_put_and_get_many(void **context) {
+    Queue *queue = queue_create(4, sizeof(int));
+    int const items[] = {1, 2, 3, 4, 5, 6};
+    int actual_items[6] = {0};
+    size_t item_count = 3;
+
+    /* Move the indices near the end of the buffer. */
+    assert_int_equal(RES_OK, queue_put_many(queue, items, &item_count, 3,
+                                            PLATFORM_TICKS_FOREVER));
+    assert_int_equal(RES_OK, queue_get_many(queue, actual_items, &item_count, 3,
+                                            PLATFORM_TICKS_FOREVER));
+    assert_int_equal(3, item_count);
+
+    /* As many as fit are queued. */
+    item_count = 6;
+    assert_int_equal(RES_OK, queue_put_many(queue, items, &item_count, 1,
+                                            PLATFORM_TICKS_FOREVER));
+    assert_int_equal(4, item_count);
+    assert_true(queue_is_full(queue));
+
+    item_count = 6;
+    assert_int_equal(RES_OK, queue_get_many_no_wait(queue, actual_items, &item_count));
+    assert_int_equal(4, item_count);
+    assert_memory_equal(items, actual_items, 4 * sizeof(int));
+    assert_int_equal(RES_QUEUE_EMPTY,
+                     queue_get_many_no_wait(queue, actual_items, &item_count));
+    assert_int_equal(0, item_count);
+
+    /* The minimum count must be within the batch and the queue. */
+    item_count = 6;
+    assert_int_equal(RES_INVALID_VALUE, queue_get_many(queue, actual_items, &item_count,
+                                                       0, PLATFORM_TICKS_FOREVER));
+    assert_int_equal(RES_INVALID_VALUE, queue_get_many(queue, actual_items, &item_count,
+                                                       5, PLATFORM_TICKS_FOREVER));
+
+    queue_free(queue);
+}
+
+typedef struct batch_get {
+    Queue *queue;
+    int items[8];
+    size_t item_count;
+    Result result;
+} BatchGet;
+
+static void batch_get_coro(void *context) {
+    BatchGet *batch = context;
+    PlatformTick const timeout = 100 * platform_get_ticks_per_ms();
+    batch->item_count = 8;
+    batch->result = queue_get_many(batch->queue, batch->items, &batch->item_count, 3,
+                                   timeout);
+}
+
+/*!
+ * @brief Tests a batch get waits until the minimum count of items is queued.
+ */
+static void test_queue_get_many_waits_for_min(void **context) {
+    BatchGet batch = {.queue = queue_create(4, sizeof(int)), .result = RES_TIMEOUT};
+    int const items[] = {1, 2, 3};
+    size_t item_count = 2;
+
+    Coro *get_coro = coro_create(batch_get_coro, &batch, DEFAULT_STACK_SIZE);
+    round_robin_scheduler_add_coro((RoundRobinScheduler *)context_get_scheduler(),
+                                   get_coro);
+
+    queue_put(batch.queue, &items[0], PLATFORM_TICKS_FOREVER);
+    coro_yield();
+    assert_int_equal(1, queue_item_count(batch.queue));
+
+    queue_put_many_no_wait(batch.queue, &items[1], &item_count);
+    coro_join(get_coro);
+    assert_int_equal(RES_OK, batch.result);
+    assert_int_equal(3, batch.item_count);
+    assert_memory_equal(items, batch.items, sizeof(items));
+
+    round_robin_scheduler_remove_coro((RoundRobinScheduler *)context_get_scheduler(),
+                                      get_coro);
+    coro_free(get_coro);
+    queue_free(batch.queue);
+}
+
 int main(void) {
     const struct CMUnitTest tests[] = {
         cmocka_coro_unit_test(test_queue_push_no_wait_to_full),
         cmocka_coro_unit_test(test_queue_push_to_full),
         cmocka_coro_unit_test(test_queue_put_and_get),
         cmocka_coro_unit_test(test_queue_put_and_get_reverse_order),
+        cmocka_coro_unit_test(test_queue_get_timeout),
+        cmocka_coro_unit_test(test_queue_reserve_and_commit),
+        cmocka_coro_unit_test(test_queue_peek_and_release),
+        cmocka_coro_unit_test(test_queue_put_waits_for_commit),
+        cmocka_coro_unit_test(test_queue_put_and_get_many),
+        cmocka_coro_unit_test(test_queue_get_many_waits_for_min),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
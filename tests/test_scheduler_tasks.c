@@ -0,0 +1,181 @@
+/*!
+ * @file
+ * @brief Tests adding, removing and reaping scheduler tasks.
+ */
+
+#include <poco/poco.h>
+
+// cmocka requires these dependencies
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+// cmocka also needs to be the last included
+#include <cmocka.h>
+
+#define TASK_CAPACITY (4)
+#define SPAWN_COUNT (32)
+
+typedef struct spawner {
+    Scheduler *scheduler;
+    StackPool *pool;
+    size_t finished_count;
+} Spawner;
+
+static void noop_task(void *context) { (void)context; }
+
+static void counting_task(void *context) {
+    Spawner *spawner = context;
+    coro_yield();
+    spawner->finished_count++;
+}
+
+/* Keeps the scheduler full of short-lived tasks, never joining them. */
+static void spawning_task(void *context) {
+    Spawner *spawner = context;
+    RoundRobinScheduler *scheduler = (RoundRobinScheduler *)spawner->scheduler;
+
+    for (size_t idx = 0; idx < SPAWN_COUNT; ++idx) {
+        Coro *coro = stack_pool_coro_create(spawner->pool, counting_task, spawner,
+                                            DEFAULT_STACK_SIZE);
+        assert_non_null(coro);
+        while (round_robin_scheduler_add_coro(scheduler, coro) != RES_OK) {
+            /* Full, let finished tasks be reaped. */
+            coro_yield();
+        }
+    }
+}
+
+static void counting_reaper(Coro *coro, void *context) {
+    size_t *reaped_count = context;
+    (*reaped_count)++;
+    coro_free(coro);
+}
+
+/*!
+ * @brief Tasks are packed at the front of the table, in the order given.
+ */
+static void test_scheduler_tasks_packed(void **state) {
+    Coro *coros[] = {NULL, coro_create(noop_task, NULL, MIN_STACK_SIZE), NULL,
+                     coro_create(noop_task, NULL, MIN_STACK_SIZE)};
+    Coro *first = coros[1];
+    Coro *second = coros[3];
+    RoundRobinScheduler *scheduler =
+        (RoundRobinScheduler *)round_robin_scheduler_create(coros, 4);
+
+    assert_int_equal(scheduler->core.all_tasks, 2);
+    assert_ptr_equal(scheduler->core.tasks[0], first);
+    assert_ptr_equal(scheduler->core.tasks[1], second);
+    assert_null(scheduler->core.tasks[2]);
+    assert_int_equal(first->task_index, 0);
+    assert_int_equal(second->task_index, 1);
+
+    round_round_robin_scheduler_free(scheduler);
+    coro_free(first);
+    coro_free(second);
+}
+
+/*!
+ * @brief Removing a task moves the last task into its slot, freeing the last slot.
+ */
+static void test_scheduler_tasks_add_remove(void **state) {
+    Coro *none[TASK_CAPACITY] = {0};
+    Coro *coros[TASK_CAPACITY + 1];
+    RoundRobinScheduler *scheduler =
+        (RoundRobinScheduler *)round_robin_scheduler_create(none, TASK_CAPACITY);
+
+    for (size_t idx = 0; idx <= TASK_CAPACITY; ++idx) {
+        coros[idx] = coro_create(noop_task, NULL, MIN_STACK_SIZE);
+    }
+
+    for (size_t idx = 0; idx < TASK_CAPACITY; ++idx) {
+        assert_int_equal(round_robin_scheduler_add_coro(scheduler, coros[idx]), RES_OK);
+    }
+    assert_int_equal(round_robin_scheduler_add_coro(scheduler, coros[TASK_CAPACITY]),
+                     RES_NO_MEM);
+
+    round_robin_scheduler_remove_coro(scheduler, coros[1]);
+    assert_int_equal(scheduler->core.all_tasks, TASK_CAPACITY - 1);
+    assert_ptr_equal(scheduler->core.tasks[1], coros[TASK_CAPACITY - 1]);
+    assert_int_equal(coros[TASK_CAPACITY - 1]->task_index, 1);
+
+    /* Not managed by the scheduler, ignored. */
+    round_robin_scheduler_remove_coro(scheduler, coros[1]);
+    round_robin_scheduler_remove_coro(scheduler, coros[TASK_CAPACITY]);
+    assert_int_equal(scheduler->core.all_tasks, TASK_CAPACITY - 1);
+
+    assert_int_equal(round_robin_scheduler_add_coro(scheduler, coros[TASK_CAPACITY]),
+                     RES_OK);
+    assert_int_equal(coros[TASK_CAPACITY]->task_index, TASK_CAPACITY - 1);
+
+    round_round_robin_scheduler_free(scheduler);
+    for (size_t idx = 0; idx <= TASK_CAPACITY; ++idx) {
+        coro_free(coros[idx]);
+    }
+}
+
+/*!
+ * @brief Finished tasks are reaped, returning their stacks to the pool, so a small task
+ * table can run any number of short-lived tasks.
+ */
+static void test_scheduler_tasks_reaped_to_pool(void **state) {
+    size_t const classes[] = {DEFAULT_STACK_SIZE};
+    Coro *none[TASK_CAPACITY] = {0};
+    Spawner spawner = {.pool = stack_pool_create(classes, 1), .finished_count = 0};
+
+    spawner.scheduler = round_robin_scheduler_create(none, TASK_CAPACITY);
+    RoundRobinScheduler *scheduler = (RoundRobinScheduler *)spawner.scheduler;
+    round_robin_scheduler_set_reaper(scheduler, stack_pool_reap, spawner.pool);
+
+    Coro *spawning = stack_pool_coro_create(spawner.pool, spawning_task, &spawner,
+                                            DEFAULT_STACK_SIZE);
+    assert_int_equal(round_robin_scheduler_add_coro(scheduler, spawning), RES_OK);
+
+    scheduler_run(spawner.scheduler);
+
+    assert_int_equal(spawner.finished_count, SPAWN_COUNT);
+    assert_int_equal(scheduler->core.all_tasks, 0);
+    /* One stack per slot, and the next task created while the table is full. */
+    assert_true(spawner.pool->classes[0].total_count <= TASK_CAPACITY + 1);
+    assert_int_equal(spawner.pool->classes[0].free_count,
+                     spawner.pool->classes[0].total_count);
+
+    round_round_robin_scheduler_free(scheduler);
+    stack_pool_free(spawner.pool);
+}
+
+/*!
+ * @brief The priority scheduler reaps its finished tasks too.
+ */
+static void test_scheduler_tasks_priority_reaper(void **state) {
+    Coro *coros[TASK_CAPACITY];
+    uint8_t priorities[TASK_CAPACITY];
+    size_t reaped_count = 0;
+
+    for (size_t idx = 0; idx < TASK_CAPACITY; ++idx) {
+        coros[idx] = coro_create(noop_task, NULL, MIN_STACK_SIZE);
+        priorities[idx] = (uint8_t)idx;
+    }
+
+    PriorityScheduler *scheduler = (PriorityScheduler *)priority_scheduler_create(
+        coros, priorities, TASK_CAPACITY);
+    priority_scheduler_set_reaper(scheduler, counting_reaper, &reaped_count);
+
+    scheduler_run((Scheduler *)scheduler);
+
+    assert_int_equal(reaped_count, TASK_CAPACITY);
+    assert_int_equal(scheduler->core.all_tasks, 0);
+
+    priority_scheduler_free(scheduler);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_scheduler_tasks_packed),
+        cmocka_unit_test(test_scheduler_tasks_add_remove),
+        cmocka_unit_test(test_scheduler_tasks_reaped_to_pool),
+        cmocka_unit_test(test_scheduler_tasks_priority_reaper),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
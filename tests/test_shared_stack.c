@@ -0,0 +1,161 @@
+/*!
+ * @file
+ * @brief Tests coroutines sharing a stack.
+ */
+
+#include "cmocka_coro_helper.h"
+#include <poco/poco.h>
+
+// cmocka requires these dependencies
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+// cmocka also needs to be the last included
+#include <cmocka.h>
+
+#define SHARED_STACK_COUNT ((64 * 1024) / sizeof(PlatformStackElement))
+#define TASK_COUNT (4)
+#define YIELD_COUNT (8)
+
+/** Locals kept by each task across yields. */
+#define FRAME_BYTES (2 * 1024)
+
+static PlatformStackElement static_stack[SHARED_STACK_COUNT];
+
+typedef struct frame_state {
+    uint8_t seed;
+    size_t verified_count;
+    SharedStack *shared;
+} FrameState;
+
+static void frame_task(void *context) {
+    FrameState *state = context;
+    uint8_t volatile frame[FRAME_BYTES];
+
+    for (size_t idx = 0; idx < FRAME_BYTES; ++idx) {
+        frame[idx] = (uint8_t)(idx + state->seed);
+    }
+
+    for (size_t yield = 0; yield < YIELD_COUNT; ++yield) {
+        coro_yield();
+        for (size_t idx = 0; idx < FRAME_BYTES; ++idx) {
+            assert_int_equal(frame[idx], (uint8_t)(idx + state->seed));
+        }
+        state->verified_count++;
+    }
+}
+
+static void nested_create_task(void *context) {
+    FrameState *state = context;
+    Coro nested;
+
+    /* The stack holds our own frames. */
+    assert_null(coro_create_shared_static(&nested, frame_task, state, state->shared));
+    state->verified_count++;
+}
+
+/*!
+ * @brief Interleaved coroutines keep their locals, although they run on the same stack.
+ */
+static void test_shared_stack_interleaved(void **state) {
+    SharedStack *shared = shared_stack_create(SHARED_STACK_COUNT);
+    FrameState states[TASK_COUNT];
+    Coro *tasks[TASK_COUNT];
+
+    for (size_t idx = 0; idx < TASK_COUNT; ++idx) {
+        states[idx] = (FrameState){.seed = (uint8_t)(idx * 37), .verified_count = 0};
+        tasks[idx] = coro_create_shared(frame_task, &states[idx], shared);
+        assert_non_null(tasks[idx]);
+        assert_ptr_equal(shared->owner, tasks[idx]);
+    }
+
+    Scheduler *scheduler = round_robin_scheduler_create(tasks, TASK_COUNT);
+    scheduler_run(scheduler);
+
+    for (size_t idx = 0; idx < TASK_COUNT; ++idx) {
+        assert_int_equal(states[idx].verified_count, YIELD_COUNT);
+        assert_int_equal(tasks[idx]->coro_state, CORO_STATE_FINISHED);
+    }
+
+    round_round_robin_scheduler_free((RoundRobinScheduler *)scheduler);
+    for (size_t idx = 0; idx < TASK_COUNT; ++idx) {
+        coro_free(tasks[idx]);
+    }
+    assert_null(shared->owner);
+    shared_stack_free(shared);
+}
+
+/*!
+ * @brief Save buffers hold the frames in use, not the whole stack.
+ */
+static void test_shared_stack_right_sized(void **state) {
+    RoundRobinScheduler *scheduler = (RoundRobinScheduler *)context_get_scheduler();
+    SharedStack shared;
+    FrameState states[2] = {{.seed = 1}, {.seed = 2}};
+    Coro coros[2];
+
+    assert_non_null(
+        shared_stack_create_static(&shared, static_stack, SHARED_STACK_COUNT));
+    for (size_t idx = 0; idx < 2; ++idx) {
+        assert_non_null(
+            coro_create_shared_static(&coros[idx], frame_task, &states[idx], &shared));
+    }
+
+    /* Evicted before it ran, only the initial frame is saved. */
+    assert_in_range(coros[0].saved_stack_size, 1, 2 * SHARED_STACK_SAVE_MARGIN);
+
+    assert_int_equal(round_robin_scheduler_add_coro(scheduler, &coros[0]), RES_OK);
+    assert_int_equal(round_robin_scheduler_add_coro(scheduler, &coros[1]), RES_OK);
+
+    /* Both ran up to their first yield. */
+    coro_yield();
+    assert_ptr_equal(shared.owner, &coros[1]);
+
+    size_t const stack_bytes = SHARED_STACK_COUNT * sizeof(PlatformStackElement);
+    assert_in_range(coros[0].saved_stack_size, FRAME_BYTES, stack_bytes / 4);
+
+    /* Frames are moved back in. */
+    coro_yield();
+    assert_int_equal(states[0].verified_count, 1);
+    assert_in_range(coros[1].saved_stack_size, FRAME_BYTES, stack_bytes / 4);
+
+    /* Frames may hold frames of other coroutines, the stack cannot be reset. */
+    assert_null(coro_reset(&coros[1], frame_task, &states[1]));
+
+    round_robin_scheduler_remove_coro(scheduler, &coros[0]);
+    round_robin_scheduler_remove_coro(scheduler, &coros[1]);
+    assert_ptr_equal(shared.owner, &coros[1]);
+    coro_destroy_static(&coros[1]);
+    assert_null(shared.owner);
+    assert_null(coros[1].saved_stack);
+    coro_destroy_static(&coros[0]);
+}
+
+/*!
+ * @brief A coroutine cannot create coroutines on the stack it runs on.
+ */
+static void test_shared_stack_nested_create(void **state) {
+    RoundRobinScheduler *scheduler = (RoundRobinScheduler *)context_get_scheduler();
+    SharedStack *shared = shared_stack_create(SHARED_STACK_COUNT);
+    FrameState nested_state = {.shared = shared};
+    Coro *coro = coro_create_shared(nested_create_task, &nested_state, shared);
+
+    assert_int_equal(round_robin_scheduler_add_coro(scheduler, coro), RES_OK);
+    coro_join(coro);
+    assert_int_equal(nested_state.verified_count, 1);
+
+    round_robin_scheduler_remove_coro(scheduler, coro);
+    coro_free(coro);
+    shared_stack_free(shared);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_shared_stack_interleaved),
+        cmocka_coro_unit_test(test_shared_stack_right_sized),
+        cmocka_coro_unit_test(test_shared_stack_nested_create),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,144 @@
+/*!
+ * @file
+ * @brief Tests the single-producer single-consumer queue.
+ */
+
+#include "cmocka_coro_helper.h"
+#include <poco/poco.h>
+#include <poco/spsc_queue.h>
+
+#ifdef POCO_WITH_THREADS
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// cmocka requires these dependencies
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+// cmocka also needs to be the last included
+#include <cmocka.h>
+
+#define SLOT_COUNT (4)
+
+/*!
+ * @brief Tests only power of 2 item counts are accepted.
+ */
+static void test_spsc_queue_invalid_item_count(void **context) {
+    SpscQueue queue;
+    uint8_t buffer[SLOT_COUNT * sizeof(uint32_t)];
+
+    assert_null(spsc_queue_create_static(&queue, 0, sizeof(uint32_t), buffer));
+    assert_null(spsc_queue_create_static(&queue, 3, sizeof(uint32_t), buffer));
+    assert_null(spsc_queue_create(6, sizeof(uint32_t)));
+    assert_non_null(
+        spsc_queue_create_static(&queue, SLOT_COUNT, sizeof(uint32_t), buffer));
+}
+
+/*!
+ * @brief Tests items are returned in order, across the wrap of the positions.
+ */
+static void test_spsc_queue_no_wait(void **context) {
+    SpscQueue *queue = spsc_queue_create(SLOT_COUNT, sizeof(uint32_t));
+    uint32_t item = 0;
+
+    assert_non_null(queue);
+    assert_int_equal(RES_QUEUE_EMPTY, spsc_queue_get_no_wait(queue, &item));
+
+    for (uint32_t idx = 0; idx < (SLOT_COUNT * 4); ++idx) {
+        assert_int_equal(RES_OK, spsc_queue_put(queue, &idx));
+        assert_int_equal(1, spsc_queue_item_count(queue));
+        assert_int_equal(RES_OK, spsc_queue_get_no_wait(queue, &item));
+        assert_int_equal(idx, item);
+    }
+
+    for (uint32_t idx = 0; idx < SLOT_COUNT; ++idx) {
+        assert_int_equal(RES_OK, spsc_queue_put(queue, &idx));
+    }
+    assert_int_equal(SLOT_COUNT, spsc_queue_item_count(queue));
+    assert_int_equal(RES_QUEUE_FULL, spsc_queue_put(queue, &item));
+
+    for (uint32_t idx = 0; idx < SLOT_COUNT; ++idx) {
+        assert_int_equal(RES_OK, spsc_queue_get_no_wait(queue, &item));
+        assert_int_equal(idx, item);
+    }
+    assert_int_equal(0, spsc_queue_item_count(queue));
+
+    spsc_queue_free(queue);
+}
+
+/*!
+ * @brief Tests a get on an empty queue waits at least the timeout before giving up.
+ */
+static void test_spsc_queue_get_timeout(void **context) {
+    SpscQueue *queue = spsc_queue_create(SLOT_COUNT, sizeof(uint32_t));
+    uint32_t item = 0;
+    PlatformTick const timeout = 20 * platform_get_ticks_per_ms();
+
+    PlatformTick const start_ticks = platform_get_monotonic_ticks();
+    Result const result = spsc_queue_get(queue, &item, timeout);
+    PlatformTick const elapsed_ticks = platform_get_monotonic_ticks() - start_ticks;
+
+    assert_int_equal(RES_TIMEOUT, result);
+    assert_true(elapsed_ticks >= timeout);
+
+    /* A later put must not try to wake the consumer that gave up. */
+    assert_int_equal(RES_OK, spsc_queue_put(queue, &item));
+    assert_int_equal(RES_OK, spsc_queue_get(queue, &item, 0));
+
+    spsc_queue_free(queue);
+}
+
+#ifdef POCO_WITH_THREADS
+
+#define ITEM_COUNT (20000)
+
+static void *produce(void *context) {
+    SpscQueue *queue = context;
+    for (uint32_t idx = 0; idx < ITEM_COUNT; ++idx) {
+        while (spsc_queue_put(queue, &idx) == RES_QUEUE_FULL) {
+            /* Full, let the consumer run. */
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/*!
+ * @brief Tests a consumer coroutine blocked on the queue is woken by another thread,
+ * and receives every item in order.
+ */
+static void test_spsc_queue_thread_producer(void **context) {
+    SpscQueue *queue = spsc_queue_create(SLOT_COUNT, sizeof(uint32_t));
+    PlatformTick const timeout = 5000 * platform_get_ticks_per_ms();
+    pthread_t thread;
+    uint32_t item = 0;
+
+    assert_int_equal(pthread_create(&thread, NULL, produce, queue), 0);
+
+    for (uint32_t idx = 0; idx < ITEM_COUNT; ++idx) {
+        assert_int_equal(RES_OK, spsc_queue_get(queue, &item, timeout));
+        assert_int_equal(idx, item);
+    }
+
+    pthread_join(thread, NULL);
+    assert_int_equal(0, spsc_queue_item_count(queue));
+
+    spsc_queue_free(queue);
+}
+
+#endif
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_spsc_queue_invalid_item_count),
+        cmocka_unit_test(test_spsc_queue_no_wait),
+        cmocka_coro_unit_test(test_spsc_queue_get_timeout),
+#ifdef POCO_WITH_THREADS
+        cmocka_coro_unit_test(test_spsc_queue_thread_producer),
+#endif
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,131 @@
+/*!
+ * @file
+ * @brief Tests stack pool implementation.
+ */
+
+#include "cmocka_coro_helper.h"
+#include <poco/poco.h>
+#include <poco/stack_pool.h>
+
+// cmocka requires these dependencies
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+// cmocka also needs to be the last included
+#include <cmocka.h>
+
+#define SMALL_STACK (MIN_STACK_SIZE)
+#define LARGE_STACK (DEFAULT_STACK_SIZE * 2)
+
+static void noop_task(void *context) { (void)context; }
+
+/*!
+ * @brief Classes must be in ascending order, and hold at least the stack markers.
+ */
+static void test_stack_pool_invalid_classes(void **state) {
+    StackPool pool;
+    size_t const descending[] = {LARGE_STACK, SMALL_STACK};
+    size_t const too_small[] = {2};
+    size_t const valid[] = {SMALL_STACK, LARGE_STACK};
+
+    assert_null(stack_pool_create_static(&pool, descending, 2));
+    assert_null(stack_pool_create_static(&pool, too_small, 1));
+    assert_null(stack_pool_create_static(&pool, valid, 0));
+    assert_null(stack_pool_create_static(&pool, valid, STACK_POOL_MAX_CLASS_COUNT + 1));
+    assert_non_null(stack_pool_create_static(&pool, valid, 2));
+}
+
+/*!
+ * @brief Coroutines get a stack from the smallest class that fits, and requests larger
+ * than every class fail.
+ */
+static void test_stack_pool_selects_class(void **state) {
+    size_t const classes[] = {SMALL_STACK, LARGE_STACK};
+    StackPool *pool = stack_pool_create(classes, 2);
+
+    Coro *small = stack_pool_coro_create(pool, noop_task, NULL, 3);
+    Coro *large = stack_pool_coro_create(pool, noop_task, NULL, SMALL_STACK + 1);
+
+    assert_int_equal(small->stack_size, SMALL_STACK);
+    assert_int_equal(large->stack_size, LARGE_STACK);
+    assert_null(stack_pool_coro_create(pool, noop_task, NULL, LARGE_STACK + 1));
+
+    stack_pool_coro_free(pool, small);
+    stack_pool_coro_free(pool, large);
+    assert_int_equal(pool->classes[0].free_count, 1);
+    assert_int_equal(pool->classes[1].free_count, 1);
+
+    stack_pool_free(pool);
+}
+
+/*!
+ * @brief Pre-warmed stacks are used before allocating new ones.
+ */
+static void test_stack_pool_prewarm(void **state) {
+    size_t const classes[] = {SMALL_STACK};
+    StackPool *pool = stack_pool_create(classes, 1);
+    Coro *coros[4];
+
+    assert_int_equal(stack_pool_prewarm(pool, SMALL_STACK, 4), RES_OK);
+    assert_int_equal(stack_pool_prewarm(pool, LARGE_STACK, 1), RES_INVALID_VALUE);
+    assert_int_equal(pool->classes[0].free_count, 4);
+
+    for (size_t idx = 0; idx < 4; ++idx) {
+        coros[idx] = stack_pool_coro_create(pool, noop_task, NULL, SMALL_STACK);
+        assert_non_null(coros[idx]);
+    }
+    assert_int_equal(pool->classes[0].free_count, 0);
+    assert_int_equal(pool->classes[0].total_count, 4);
+
+    for (size_t idx = 0; idx < 4; ++idx) {
+        stack_pool_coro_free(pool, coros[idx]);
+    }
+    assert_int_equal(pool->classes[0].free_count, 4);
+
+    stack_pool_free(pool);
+}
+
+static void counting_task(void *context) {
+    size_t *counter = context;
+    coro_yield();
+    (*counter)++;
+}
+
+/*!
+ * @brief Coroutines spawned one after the other run on the same recycled stack.
+ */
+static void test_stack_pool_recycles_finished_coroutines(void **state) {
+    size_t const classes[] = {DEFAULT_STACK_SIZE};
+    StackPool *pool = stack_pool_create(classes, 1);
+    RoundRobinScheduler *scheduler = (RoundRobinScheduler *)context_get_scheduler();
+    size_t counter = 0;
+
+    for (size_t idx = 0; idx < 16; ++idx) {
+        Coro *coro =
+            stack_pool_coro_create(pool, counting_task, &counter, DEFAULT_STACK_SIZE);
+        assert_non_null(coro);
+        assert_int_equal(round_robin_scheduler_add_coro(scheduler, coro), RES_OK);
+
+        coro_join(coro);
+
+        round_robin_scheduler_remove_coro(scheduler, coro);
+        stack_pool_coro_free(pool, coro);
+    }
+
+    assert_int_equal(counter, 16);
+    assert_int_equal(pool->classes[0].total_count, 1);
+
+    stack_pool_free(pool);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_stack_pool_invalid_classes),
+        cmocka_unit_test(test_stack_pool_selects_class),
+        cmocka_unit_test(test_stack_pool_prewarm),
+        cmocka_coro_unit_test(test_stack_pool_recycles_finished_coroutines),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
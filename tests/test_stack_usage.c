@@ -0,0 +1,137 @@
+/*!
+ * @file
+ * @brief Tests stack usage measurement.
+ */
+
+#include "cmocka_coro_helper.h"
+#include <poco/poco.h>
+
+// cmocka requires these dependencies
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+// cmocka also needs to be the last included
+#include <cmocka.h>
+
+#define STACK_SIZE ((64 * 1024) / sizeof(PlatformStackElement))
+
+/** Stack used by the frame task, well below the stack size. */
+#define FRAME_BYTES (8 * 1024)
+#define FRAME_ELEMENTS (FRAME_BYTES / sizeof(PlatformStackElement))
+
+static PlatformStackElement static_stack[STACK_SIZE];
+
+static void noop_task(void *context) { (void)context; }
+
+static void frame_task(void *context) {
+    uint8_t volatile frame[FRAME_BYTES];
+
+    for (size_t idx = 0; idx < FRAME_BYTES; ++idx) {
+        frame[idx] = (uint8_t)(idx | 1);
+    }
+    coro_yield();
+    (void)frame[0];
+    (void)context;
+}
+
+static void run_to_completion(Coro *coro) {
+    RoundRobinScheduler *scheduler = (RoundRobinScheduler *)context_get_scheduler();
+
+    assert_int_equal(round_robin_scheduler_add_coro(scheduler, coro), RES_OK);
+    coro_join(coro);
+    round_robin_scheduler_remove_coro(scheduler, coro);
+}
+
+/*!
+ * @brief The whole stack is painted, a coroutine that has not run uses little of it.
+ */
+static void test_stack_usage_not_started(void **state) {
+    Coro coro;
+
+    coro_create_static(&coro, noop_task, NULL, static_stack, STACK_SIZE);
+
+    assert_true(coro_stack_high_water(&coro) < (STACK_SIZE / 8));
+
+    coro_destroy_static(&coro);
+}
+
+#ifndef PLATFORM_OWN_STACKS
+/*!
+ * @brief Peak use covers the deepest frame, on both painted and platform stacks.
+ */
+static void test_stack_usage_high_water(void **state) {
+    Coro coro;
+    Coro *dynamic = coro_create(frame_task, NULL, STACK_SIZE);
+
+    coro_create_static(&coro, frame_task, NULL, static_stack, STACK_SIZE);
+
+    run_to_completion(&coro);
+    run_to_completion(dynamic);
+
+    assert_in_range(coro_stack_high_water(&coro), FRAME_ELEMENTS, STACK_SIZE - 2);
+    assert_in_range(coro_stack_high_water(dynamic), FRAME_ELEMENTS, STACK_SIZE - 2);
+
+    coro_destroy_static(&coro);
+    coro_free(dynamic);
+}
+
+/*!
+ * @brief An overwritten start marker reports the whole stack as used.
+ */
+static void test_stack_usage_overflow(void **state) {
+    Coro coro;
+
+    coro_create_static(&coro, noop_task, NULL, static_stack, STACK_SIZE);
+    static_stack[0] = 1;
+
+    assert_int_equal(coro_stack_high_water(&coro), STACK_SIZE - 2);
+
+    coro_destroy_static(&coro);
+}
+#endif
+
+/*!
+ * @brief The report lists every coroutine of the scheduler, up to the space given.
+ */
+static void test_stack_usage_scheduler_report(void **state) {
+    Scheduler *scheduler = context_get_scheduler();
+    Coro *coro = coro_create(frame_task, NULL, STACK_SIZE);
+    CoroStackUsage usages[2];
+
+    assert_int_equal(
+        round_robin_scheduler_add_coro((RoundRobinScheduler *)scheduler, coro), RES_OK);
+    coro_join(coro);
+
+    /* The test coroutine, and the frame task. */
+    assert_int_equal(scheduler_stack_report(scheduler, usages, 2), 2);
+    assert_int_equal(scheduler_stack_report(scheduler, usages, 1), 2);
+
+    scheduler_stack_report(scheduler, usages, 2);
+    for (size_t idx = 0; idx < 2; ++idx) {
+        assert_int_equal(usages[idx].stack_size, usages[idx].coro->stack_size);
+        assert_int_equal(usages[idx].high_water,
+                         coro_stack_high_water(usages[idx].coro));
+#ifndef PLATFORM_OWN_STACKS
+        if (usages[idx].coro == coro) {
+            assert_true(usages[idx].high_water >= FRAME_ELEMENTS);
+        }
+#endif
+    }
+
+    round_robin_scheduler_remove_coro((RoundRobinScheduler *)scheduler, coro);
+    coro_free(coro);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_stack_usage_not_started),
+#ifndef PLATFORM_OWN_STACKS
+        cmocka_coro_unit_test(test_stack_usage_high_water),
+        cmocka_unit_test(test_stack_usage_overflow),
+#endif
+        cmocka_coro_unit_test(test_stack_usage_scheduler_report),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
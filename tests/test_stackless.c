@@ -0,0 +1,147 @@
+/*!
+ * @file
+ * @brief Tests stackless coroutines.
+ */
+
+#include <poco/poco.h>
+
+// cmocka requires these dependencies
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+// cmocka also needs to be the last included
+#include <cmocka.h>
+
+#define ITEM_COUNT (64)
+#define TIMER_COUNT (256)
+#define TIMER_REPEAT (3)
+
+typedef struct consumer {
+    Queue *queue;
+    uint32_t item;
+    uint32_t sum;
+    size_t received;
+} Consumer;
+
+typedef struct timer_state {
+    size_t repeat;
+    size_t *expired_count;
+} TimerState;
+
+static void producer_task(void *context) {
+    Queue *queue = context;
+    for (uint32_t item = 1; item <= ITEM_COUNT; ++item) {
+        assert_int_equal(queue_put(queue, &item, PLATFORM_TICKS_FOREVER), RES_OK);
+    }
+}
+
+static CoroSignal consumer_step(Coro *coro, void *context) {
+    Consumer *consumer = context;
+
+    CORO_STACKLESS_BEGIN(coro);
+    while (consumer->received < ITEM_COUNT) {
+        CORO_STACKLESS_WAIT_UNTIL(
+            coro, queue_get_no_wait(consumer->queue, &consumer->item) == RES_OK,
+            CORO_EVTSINK_QUEUE_NOT_EMPTY, consumer->queue);
+        consumer->sum += consumer->item;
+        consumer->received++;
+    }
+    CORO_STACKLESS_END(coro);
+}
+
+static CoroSignal timer_step(Coro *coro, void *context) {
+    TimerState *timer = context;
+
+    CORO_STACKLESS_BEGIN(coro);
+    for (timer->repeat = 0; timer->repeat < TIMER_REPEAT; ++timer->repeat) {
+        CORO_STACKLESS_DELAY(coro, 1);
+        (*timer->expired_count)++;
+        CORO_STACKLESS_YIELD(coro);
+    }
+    CORO_STACKLESS_END(coro);
+}
+
+static void joining_task(void *context) {
+    Coro *timer_coro = context;
+    coro_join(timer_coro);
+    assert_int_equal(timer_coro->coro_state, CORO_STATE_FINISHED);
+}
+
+/*!
+ * @brief A stackless consumer blocks on a queue fed by a stackful producer.
+ */
+static void test_stackless_queue_consumer(void **state) {
+    Consumer consumer = {.queue = queue_create(4, sizeof(uint32_t))};
+    CoroStackless stackless;
+    Coro *tasks[] = {
+        coro_create(producer_task, consumer.queue, DEFAULT_STACK_SIZE),
+        coro_create_stackless_static(&stackless, consumer_step, &consumer),
+    };
+    Scheduler *scheduler = round_robin_scheduler_create(tasks, 2);
+
+    scheduler_run(scheduler);
+
+    assert_int_equal(consumer.received, ITEM_COUNT);
+    assert_int_equal(consumer.sum, ITEM_COUNT * (ITEM_COUNT + 1) / 2);
+    assert_int_equal(tasks[1]->coro_state, CORO_STATE_FINISHED);
+
+    round_round_robin_scheduler_free((RoundRobinScheduler *)scheduler);
+    coro_free(tasks[0]);
+    queue_free(consumer.queue);
+}
+
+/*!
+ * @brief Many stackless timers run next to a stackful coroutine joining one of them.
+ */
+static void test_stackless_timers(void **state) {
+    static TimerState timers[TIMER_COUNT];
+    Coro *tasks[TIMER_COUNT + 1];
+    size_t expired_count = 0;
+
+    for (size_t idx = 0; idx < TIMER_COUNT; ++idx) {
+        timers[idx].expired_count = &expired_count;
+        tasks[idx] = coro_create_stackless(timer_step, &timers[idx]);
+        assert_non_null(tasks[idx]);
+    }
+    tasks[TIMER_COUNT] = coro_create(joining_task, tasks[0], DEFAULT_STACK_SIZE);
+
+    Scheduler *scheduler = round_robin_scheduler_create(tasks, TIMER_COUNT + 1);
+    scheduler_run(scheduler);
+
+    assert_int_equal(expired_count, TIMER_COUNT * TIMER_REPEAT);
+    assert_int_equal(tasks[TIMER_COUNT]->coro_state, CORO_STATE_FINISHED);
+
+    round_round_robin_scheduler_free((RoundRobinScheduler *)scheduler);
+    for (size_t idx = 0; idx <= TIMER_COUNT; ++idx) {
+        coro_free(tasks[idx]);
+    }
+}
+
+/*!
+ * @brief Stackless coroutines have no stack to measure, nor to reuse, and leave the
+ * execution state of stackful coroutines out.
+ */
+static void test_stackless_has_no_stack(void **state) {
+    CoroStackless storage;
+
+    assert_true(sizeof(CoroStackless) + sizeof(PlatformContext) <= sizeof(Coro));
+    assert_null(coro_create_stackless_static(&storage, NULL, NULL));
+    Coro *coro = coro_create_stackless_static(&storage, timer_step, NULL);
+    assert_ptr_equal(coro, &storage);
+
+    assert_int_equal(coro_stack_high_water(coro), 0);
+    assert_null(coro_reset(coro, NULL, NULL));
+
+    coro_destroy_static(coro);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_stackless_queue_consumer),
+        cmocka_unit_test(test_stackless_timers),
+        cmocka_unit_test(test_stackless_has_no_stack),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
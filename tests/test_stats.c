@@ -0,0 +1,163 @@
+/*!
+ * @file
+ * @brief Tests runtime statistics.
+ */
+
+#include <poco/poco.h>
+
+// cmocka requires these dependencies
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+// cmocka also needs to be the last included
+#include <cmocka.h>
+
+#define DELAY_MS (10)
+#define DELAY_COUNT (3)
+#define ITEM_COUNT (4)
+
+/** Timers may expire a little early, within a tick. */
+#define MIN_DELAY_NS ((int64_t)(DELAY_MS - 1) * 1000000)
+
+static void delay_task(void *context) {
+    for (size_t idx = 0; idx < DELAY_COUNT; ++idx) {
+        coro_yield_delay(DELAY_MS);
+    }
+}
+
+#ifdef POCO_WITH_STATS
+static void producer_task(void *context) {
+    Queue *queue = context;
+    for (uint32_t item = 0; item < ITEM_COUNT; ++item) {
+        coro_yield_delay(DELAY_MS);
+        assert_int_equal(queue_put(queue, &item, PLATFORM_TICKS_FOREVER), RES_OK);
+    }
+}
+
+static void consumer_task(void *context) {
+    Queue *queue = context;
+    uint32_t item = 0;
+    for (size_t idx = 0; idx < ITEM_COUNT; ++idx) {
+        assert_int_equal(queue_get(queue, &item, PLATFORM_TICKS_FOREVER), RES_OK);
+    }
+}
+
+static void event_task(void *context) {
+    Event *event = context;
+    assert_int_equal(event_get(event, 1, 1, false, PLATFORM_TICKS_FOREVER), 1);
+}
+
+/*!
+ * @brief Resumes, running time and delays are accounted to the coroutine.
+ */
+static void test_stats_delays(void **state) {
+    Coro *coro = coro_create(delay_task, NULL, DEFAULT_STACK_SIZE);
+    Scheduler *scheduler = round_robin_scheduler_create(&coro, 1);
+    CoroStats stats;
+    SchedulerStats scheduler_stats;
+
+    scheduler_run(scheduler);
+
+    assert_int_equal(coro_get_stats(coro, &stats), RES_OK);
+    assert_int_equal(stats.resume_count, DELAY_COUNT + 1);
+    assert_true(stats.running_ns > 0);
+    assert_true(stats.blocked_ns[CORO_EVTSINK_DELAY] >= DELAY_COUNT * MIN_DELAY_NS);
+    assert_int_equal(stats.blocked_ns[CORO_EVTSINK_QUEUE_NOT_EMPTY], 0);
+    assert_true(stats.max_ready_ns <= stats.ready_ns);
+
+    /* The only task was delayed, the scheduler was idle meanwhile. */
+    assert_int_equal(scheduler_get_stats(scheduler, &scheduler_stats), RES_OK);
+    assert_true(scheduler_stats.pass_count >= stats.resume_count);
+    assert_true(scheduler_stats.idle_ns >= DELAY_COUNT * MIN_DELAY_NS);
+    assert_int_equal(scheduler_stats.event_overflow_count, 0);
+
+    round_round_robin_scheduler_free((RoundRobinScheduler *)scheduler);
+    coro_free(coro);
+}
+
+/*!
+ * @brief Blocked time is split by the type of sink blocked on.
+ */
+static void test_stats_blocked_by_sink(void **state) {
+    Queue *queue = queue_create(ITEM_COUNT, sizeof(uint32_t));
+    Coro *coros[] = {
+        coro_create(producer_task, queue, DEFAULT_STACK_SIZE),
+        coro_create(consumer_task, queue, DEFAULT_STACK_SIZE),
+    };
+    Scheduler *scheduler = round_robin_scheduler_create(coros, 2);
+    CoroStats producer;
+    CoroStats consumer;
+
+    scheduler_run(scheduler);
+
+    coro_get_stats(coros[0], &producer);
+    coro_get_stats(coros[1], &consumer);
+    assert_true(producer.blocked_ns[CORO_EVTSINK_DELAY] >= ITEM_COUNT * MIN_DELAY_NS);
+    assert_true(consumer.blocked_ns[CORO_EVTSINK_QUEUE_NOT_EMPTY] >=
+                ITEM_COUNT * MIN_DELAY_NS);
+    assert_int_equal(consumer.blocked_ns[CORO_EVTSINK_DELAY], 0);
+
+    round_round_robin_scheduler_free((RoundRobinScheduler *)scheduler);
+    coro_free(coros[0]);
+    coro_free(coros[1]);
+    queue_free(queue);
+}
+
+/*!
+ * @brief Dropped external events are counted.
+ */
+static void test_stats_event_overflow(void **state) {
+    Event *event = event_create(1);
+    Coro *coro = coro_create(event_task, event, DEFAULT_STACK_SIZE);
+    Scheduler *scheduler = round_robin_scheduler_create(&coro, 1);
+    Event others[SCHEDULER_MAX_EXTERNAL_EVENT_COUNT + 1];
+    SchedulerStats stats;
+
+    /* One more distinct event than the ring holds, before the scheduler gets to run. */
+    for (size_t idx = 0; idx <= SCHEDULER_MAX_EXTERNAL_EVENT_COUNT; ++idx) {
+        CoroEventSource const source = {.type = CORO_EVTSRC_EVENT_SET,
+                                        .params.subject = &others[idx]};
+        scheduler_notify_from_isr(scheduler, &source);
+    }
+    scheduler_run(scheduler);
+
+    scheduler_get_stats(scheduler, &stats);
+    assert_int_equal(stats.event_overflow_count, 1);
+
+    round_round_robin_scheduler_free((RoundRobinScheduler *)scheduler);
+    coro_free(coro);
+    event_free(event);
+}
+#else
+/*!
+ * @brief Without POCO_WITH_STATS, no statistics are available.
+ */
+static void test_stats_not_supported(void **state) {
+    Coro *coro = coro_create(delay_task, NULL, DEFAULT_STACK_SIZE);
+    Scheduler *scheduler = round_robin_scheduler_create(&coro, 1);
+    CoroStats stats;
+    SchedulerStats scheduler_stats;
+
+    assert_int_equal(coro_get_stats(coro, &stats), RES_NOT_SUPPORTED);
+    assert_int_equal(scheduler_get_stats(scheduler, &scheduler_stats),
+                     RES_NOT_SUPPORTED);
+
+    round_round_robin_scheduler_free((RoundRobinScheduler *)scheduler);
+    coro_free(coro);
+}
+#endif
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+#ifdef POCO_WITH_STATS
+        cmocka_unit_test(test_stats_delays),
+        cmocka_unit_test(test_stats_blocked_by_sink),
+        cmocka_unit_test(test_stats_event_overflow),
+#else
+        cmocka_unit_test(test_stats_not_supported),
+#endif
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,104 @@
+/*!
+ * @file
+ * @brief Tests timer heap implementation.
+ */
+
+#include <poco/timer_heap.h>
+#include <string.h>
+
+// cmocka requires these dependencies
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+// cmocka also needs to be the last included
+#include <cmocka.h>
+
+#define TIMER_COUNT (64)
+
+/*!
+ * @brief Nothing expires from an empty heap.
+ */
+static void test_timer_heap_empty(void **state) {
+    TimerHeap heap;
+    timer_heap_init(&heap);
+
+    assert_true(timer_heap_is_empty(&heap));
+    assert_null(timer_heap_pop_expired(&heap, 100));
+}
+
+/*!
+ * @brief Timers expire in deadline order, and only once due.
+ */
+static void test_timer_heap_expires_in_order(void **state) {
+    TimerHeap heap;
+    TimerNode nodes[TIMER_COUNT];
+
+    timer_heap_init(&heap);
+
+    // Insert in a scrambled order.
+    for (size_t idx = 0; idx < TIMER_COUNT; ++idx) {
+        timer_node_init(&nodes[idx]);
+        timer_heap_insert(&heap, &nodes[idx], (PlatformTick)((idx * 37) % TIMER_COUNT));
+    }
+
+    assert_null(timer_heap_pop_expired(&heap, -1));
+
+    for (PlatformTick now = 0; now < TIMER_COUNT; ++now) {
+        TimerNode *node = timer_heap_pop_expired(&heap, now);
+        assert_non_null(node);
+        assert_int_equal(node->deadline, now);
+        assert_false(timer_node_is_linked(node));
+        assert_null(timer_heap_pop_expired(&heap, now));
+    }
+
+    assert_true(timer_heap_is_empty(&heap));
+}
+
+/*!
+ * @brief Removed timers never expire, and the remaining ones keep their order.
+ */
+static void test_timer_heap_remove(void **state) {
+    TimerHeap heap;
+    TimerNode nodes[TIMER_COUNT];
+
+    timer_heap_init(&heap);
+
+    for (size_t idx = 0; idx < TIMER_COUNT; ++idx) {
+        timer_node_init(&nodes[idx]);
+        timer_heap_insert(&heap, &nodes[idx], (PlatformTick)((idx * 37) % TIMER_COUNT));
+    }
+
+    // Pop a few to give the heap some structure, then remove all odd deadlines.
+    for (PlatformTick now = 0; now < 4; ++now) {
+        assert_non_null(timer_heap_pop_expired(&heap, now));
+    }
+
+    for (size_t idx = 0; idx < TIMER_COUNT; ++idx) {
+        if ((nodes[idx].deadline % 2) && timer_node_is_linked(&nodes[idx])) {
+            timer_heap_remove(&heap, &nodes[idx]);
+        }
+    }
+
+    PlatformTick previous_deadline = 0;
+    size_t expired_count = 0;
+    TimerNode *node = NULL;
+    while ((node = timer_heap_pop_expired(&heap, TIMER_COUNT)) != NULL) {
+        assert_int_equal(node->deadline % 2, 0);
+        assert_true(node->deadline > previous_deadline);
+        previous_deadline = node->deadline;
+        expired_count++;
+    }
+
+    assert_int_equal(expired_count, (TIMER_COUNT - 4) / 2);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_timer_heap_empty),
+        cmocka_unit_test(test_timer_heap_expires_in_order),
+        cmocka_unit_test(test_timer_heap_remove),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
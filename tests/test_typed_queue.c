@@ -0,0 +1,179 @@
+/*!
+ * @file
+ * @brief Tests typed queues.
+ */
+
+#include "cmocka_coro_helper.h"
+#include <poco/poco.h>
+#include <poco/typed_queue.h>
+
+// cmocka requires these dependencies
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+// cmocka also needs to be the last included
+#include <cmocka.h>
+
+#define ITEM_COUNT (16)
+#define CONTENDED_ROUNDS (500)
+
+/** Test item for queue testing. */
+typedef struct dummy_item {
+    uint32_t a;
+    uint8_t b;
+    uint32_t c;
+} dummy_item_t;
+
+POCO_QUEUE_DEFINE(item_queue, dummy_item_t, 4)
+
+static void producer_coro(void *context) {
+    item_queue *queue = context;
+    for (uint32_t idx = 0; idx < ITEM_COUNT; ++idx) {
+        dummy_item_t const item = {.a = idx, .b = (uint8_t)idx, .c = 2 * idx};
+        assert_int_equal(RES_OK, item_queue_put(queue, &item, PLATFORM_TICKS_FOREVER));
+    }
+}
+
+/** Coroutines contending with a timed get. */
+typedef struct contention {
+    item_queue queue;
+    size_t stolen; /**< Items taken by the stealer. */
+    bool done;
+} Contention;
+
+static void contended_producer_coro(void *context) {
+    Contention *contention = context;
+    dummy_item_t const item = {0};
+    for (size_t round = 0; (round < CONTENDED_ROUNDS) && !contention->done; ++round) {
+        assert_int_equal(RES_OK, item_queue_put(&contention->queue, &item,
+                                                PLATFORM_TICKS_FOREVER));
+        coro_yield_delay(1);
+    }
+}
+
+static void stealer_coro(void *context) {
+    Contention *contention = context;
+    dummy_item_t item = {0};
+    while (!contention->done) {
+        if (item_queue_get_no_wait(&contention->queue, &item) == RES_OK) {
+            contention->stolen++;
+        }
+        coro_yield();
+    }
+}
+
+/*!
+ * @brief Tests items are returned in order, across the wrap of the indices.
+ */
+static void test_typed_queue_no_wait(void **context) {
+    item_queue queue;
+    dummy_item_t item = {0};
+
+    item_queue_init(&queue);
+    assert_true(item_queue_is_empty(&queue));
+    assert_int_equal(RES_QUEUE_EMPTY, item_queue_get_no_wait(&queue, &item));
+
+    for (uint32_t idx = 0; idx < ITEM_COUNT; ++idx) {
+        dummy_item_t const expected = {.a = idx, .b = (uint8_t)idx, .c = 2 * idx};
+        assert_int_equal(RES_OK, item_queue_put_no_wait(&queue, &expected));
+        assert_int_equal(1, item_queue_item_count(&queue));
+        assert_int_equal(RES_OK, item_queue_get_no_wait(&queue, &item));
+        assert_memory_equal(&expected, &item, sizeof(item));
+    }
+
+    for (uint32_t idx = 0; idx < 4; ++idx) {
+        assert_int_equal(RES_OK, item_queue_put_no_wait(&queue, &item));
+    }
+    assert_true(item_queue_is_full(&queue));
+    assert_int_equal(RES_QUEUE_FULL, item_queue_put_no_wait(&queue, &item));
+    assert_int_equal(RES_TIMEOUT, item_queue_put(&queue, &item, 0));
+}
+
+/*!
+ * @brief Tests a producer blocks on a full queue until the consumer makes room.
+ */
+static void test_typed_queue_blocking(void **context) {
+    item_queue queue;
+    dummy_item_t item = {0};
+
+    item_queue_init(&queue);
+    Coro *coro = coro_create(producer_coro, &queue, DEFAULT_STACK_SIZE);
+    round_robin_scheduler_add_coro((RoundRobinScheduler *)context_get_scheduler(),
+                                   coro);
+
+    for (uint32_t idx = 0; idx < ITEM_COUNT; ++idx) {
+        assert_int_equal(RES_OK, item_queue_get(&queue, &item, PLATFORM_TICKS_FOREVER));
+        assert_int_equal(idx, item.a);
+        assert_int_equal(2 * idx, item.c);
+    }
+    coro_join(coro);
+    assert_true(item_queue_is_empty(&queue));
+
+    round_robin_scheduler_remove_coro((RoundRobinScheduler *)context_get_scheduler(),
+                                      coro);
+    coro_free(coro);
+}
+
+/*!
+ * @brief Tests a get on an empty queue waits at least the timeout before giving up.
+ */
+static void test_typed_queue_get_timeout(void **context) {
+    item_queue queue = {0};
+    dummy_item_t item = {0};
+    PlatformTick const timeout = 20 * platform_get_ticks_per_ms();
+
+    PlatformTick const start_ticks = platform_get_monotonic_ticks();
+    Result const result = item_queue_get(&queue, &item, timeout);
+    PlatformTick const elapsed_ticks = platform_get_monotonic_ticks() - start_ticks;
+
+    assert_int_equal(RES_TIMEOUT, result);
+    assert_true(elapsed_ticks >= timeout);
+}
+
+/*!
+ * @brief Tests a get woken by items another consumer takes first still times out within
+ * its timeout.
+ */
+static void test_typed_queue_contended_timeout(void **context) {
+    Contention contention = {0};
+    dummy_item_t item = {0};
+    PlatformTick const timeout = 20 * platform_get_ticks_per_ms();
+    RoundRobinScheduler *scheduler = (RoundRobinScheduler *)context_get_scheduler();
+
+    item_queue_init(&contention.queue);
+    /* The stealer is always ready, ahead of the woken getter. */
+    Coro *stealer = coro_create(stealer_coro, &contention, DEFAULT_STACK_SIZE);
+    Coro *producer =
+        coro_create(contended_producer_coro, &contention, DEFAULT_STACK_SIZE);
+    round_robin_scheduler_add_coro(scheduler, stealer);
+    round_robin_scheduler_add_coro(scheduler, producer);
+
+    PlatformTick const start_ticks = platform_get_monotonic_ticks();
+    Result const result = item_queue_get(&contention.queue, &item, timeout);
+    PlatformTick const elapsed_ticks = platform_get_monotonic_ticks() - start_ticks;
+    contention.done = true;
+
+    assert_int_equal(RES_TIMEOUT, result);
+    assert_true(contention.stolen > 0);
+    assert_true(elapsed_ticks >= timeout);
+    assert_true(elapsed_ticks < 5 * timeout);
+
+    coro_join(stealer);
+    coro_join(producer);
+    round_robin_scheduler_remove_coro(scheduler, stealer);
+    round_robin_scheduler_remove_coro(scheduler, producer);
+    coro_free(stealer);
+    coro_free(producer);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_coro_unit_test(test_typed_queue_no_wait),
+        cmocka_coro_unit_test(test_typed_queue_blocking),
+        cmocka_coro_unit_test(test_typed_queue_get_timeout),
+        cmocka_coro_unit_test(test_typed_queue_contended_timeout),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,203 @@
+/*!
+ * @file
+ * @brief Tests the work-stealing scheduler.
+ */
+
+#include <poco/poco.h>
+#include <poco/schedulers/work_stealing.h>
+#include <poco/spsc_queue.h>
+#include <pthread.h>
+#include <sched.h>
+
+// cmocka requires these dependencies
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+// cmocka also needs to be the last included
+#include <cmocka.h>
+
+#define WORKER_COUNT (4)
+#define TASK_COUNT (64)
+#define YIELD_COUNT (100)
+#define ITEM_COUNT (1000)
+#define STACK_SIZE (DEFAULT_STACK_SIZE)
+
+static Coro coroutines[TASK_COUNT];
+static PlatformStackElement coroutine_stacks[TASK_COUNT][STACK_SIZE];
+
+/** Shared state between test coroutines. */
+typedef struct test_state {
+    Queue *queue;
+    SpscQueue *spsc_queue;
+    size_t counter;
+    int64_t sum;
+    size_t failures; /**< cmocka asserts cannot be used from worker threads. */
+} TestState;
+
+static TestState test_state;
+
+static void run_tasks(CoroEntrypoint const *entrypoints, size_t const task_count) {
+    Coro *tasks[TASK_COUNT] = {0};
+
+    for (size_t idx = 0; idx < task_count; ++idx) {
+        tasks[idx] = coro_create_static(&coroutines[idx], entrypoints[idx], &test_state,
+                                        &coroutine_stacks[idx][0], STACK_SIZE);
+        assert_non_null(tasks[idx]);
+    }
+
+    Scheduler *scheduler =
+        work_stealing_scheduler_create(tasks, task_count, WORKER_COUNT);
+    assert_non_null(scheduler);
+
+    scheduler_run(scheduler);
+
+    for (size_t idx = 0; idx < task_count; ++idx) {
+        assert_int_equal(coroutines[idx].coro_state, CORO_STATE_FINISHED);
+    }
+
+    work_stealing_scheduler_free((WorkStealingScheduler *)scheduler);
+}
+
+static void counting_task(void *context) {
+    TestState *state = context;
+    for (size_t idx = 0; idx < YIELD_COUNT; ++idx) {
+        __atomic_fetch_add(&state->counter, 1, __ATOMIC_RELAXED);
+        coro_yield();
+    }
+}
+
+/*!
+ * @brief All tasks run to completion.
+ */
+static void test_work_stealing_runs_all_tasks(void **context) {
+    CoroEntrypoint entrypoints[TASK_COUNT];
+    for (size_t idx = 0; idx < TASK_COUNT; ++idx) {
+        entrypoints[idx] = counting_task;
+    }
+    test_state.counter = 0;
+
+    run_tasks(entrypoints, TASK_COUNT);
+
+    assert_int_equal(test_state.counter, TASK_COUNT * YIELD_COUNT);
+}
+
+static void producer_task(void *context) {
+    TestState *state = context;
+    for (int32_t item = 1; item <= ITEM_COUNT; ++item) {
+        if (queue_put(state->queue, &item, PLATFORM_TICKS_FOREVER) != RES_OK) {
+            __atomic_fetch_add(&state->failures, 1, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static void consumer_task(void *context) {
+    TestState *state = context;
+    for (size_t idx = 0; idx < ITEM_COUNT; ++idx) {
+        int32_t item = 0;
+        if (queue_get(state->queue, &item, PLATFORM_TICKS_FOREVER) != RES_OK) {
+            __atomic_fetch_add(&state->failures, 1, __ATOMIC_RELAXED);
+        }
+        __atomic_fetch_add(&state->sum, item, __ATOMIC_RELAXED);
+    }
+}
+
+/*!
+ * @brief Items passed through a queue by tasks on different threads are never lost,
+ * and no task misses the event unblocking it.
+ */
+static void test_work_stealing_queue_handoff(void **context) {
+    CoroEntrypoint entrypoints[8];
+    for (size_t idx = 0; idx < 8; ++idx) {
+        entrypoints[idx] = (idx % 2) ? consumer_task : producer_task;
+    }
+    test_state.queue = queue_create(4, sizeof(int32_t));
+    test_state.sum = 0;
+    test_state.failures = 0;
+
+    run_tasks(entrypoints, 8);
+
+    assert_int_equal(test_state.failures, 0);
+    assert_int_equal(test_state.sum, 4 * (ITEM_COUNT * (ITEM_COUNT + 1)) / 2);
+    queue_free(test_state.queue);
+}
+
+static void delay_task(void *context) {
+    TestState *state = context;
+    coro_yield_delay(20);
+    __atomic_fetch_add(&state->counter, 1, __ATOMIC_RELAXED);
+}
+
+/*!
+ * @brief Delayed tasks are woken once their timeout passes.
+ */
+static void test_work_stealing_delay(void **context) {
+    CoroEntrypoint entrypoints[8];
+    for (size_t idx = 0; idx < 8; ++idx) {
+        entrypoints[idx] = delay_task;
+    }
+    test_state.counter = 0;
+
+    PlatformTick const start = platform_get_monotonic_ticks();
+    run_tasks(entrypoints, 8);
+    PlatformTick const elapsed = platform_get_monotonic_ticks() - start;
+
+    assert_int_equal(test_state.counter, 8);
+    assert_true(elapsed >= 20 * platform_get_ticks_per_ms());
+}
+
+static void *isr_producer(void *context) {
+    TestState *state = context;
+    for (int32_t item = 1; item <= ITEM_COUNT; ++item) {
+        while (spsc_queue_put(state->spsc_queue, &item) == RES_QUEUE_FULL) {
+            /* Full, let the consumer run. */
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void spsc_consumer_task(void *context) {
+    TestState *state = context;
+    for (size_t idx = 0; idx < ITEM_COUNT; ++idx) {
+        int32_t item = 0;
+        if (spsc_queue_get(state->spsc_queue, &item, PLATFORM_TICKS_FOREVER) !=
+            RES_OK) {
+            __atomic_fetch_add(&state->failures, 1, __ATOMIC_RELAXED);
+        }
+        __atomic_fetch_add(&state->sum, item, __ATOMIC_RELAXED);
+    }
+}
+
+/*!
+ * @brief A task blocked on an event notified from outside of the workers, without
+ * taking the scheduler lock, is woken up.
+ */
+static void test_work_stealing_isr_notify(void **context) {
+    CoroEntrypoint entrypoints[4] = {spsc_consumer_task, counting_task, counting_task,
+                                     counting_task};
+    pthread_t thread;
+    test_state.spsc_queue = spsc_queue_create(4, sizeof(int32_t));
+    test_state.counter = 0;
+    test_state.sum = 0;
+    test_state.failures = 0;
+
+    assert_int_equal(pthread_create(&thread, NULL, isr_producer, &test_state), 0);
+    run_tasks(entrypoints, 4);
+    pthread_join(thread, NULL);
+
+    assert_int_equal(test_state.failures, 0);
+    assert_int_equal(test_state.sum, (ITEM_COUNT * (ITEM_COUNT + 1)) / 2);
+    spsc_queue_free(test_state.spsc_queue);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_work_stealing_runs_all_tasks),
+        cmocka_unit_test(test_work_stealing_queue_handoff),
+        cmocka_unit_test(test_work_stealing_delay),
+        cmocka_unit_test(test_work_stealing_isr_notify),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}